@@ -0,0 +1,189 @@
+/*
+* @author: Inan Evin
+* @website: www.inanevin.com
+* @twitter: lineupthesky
+* @github: https://github.com/inanevin/UE-DataTable-Based-Event-Manager
+* 
+* Simple Event Manager, exposed to UE4 Editor via DataTables.
+*
+* MIT License
+* Copyright (c) 2021 Inan Evin
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+* 
+*/
+
+#include "K2Node_BreakGameEvent.h"
+#include "K2Node_BroadcastGameEvent.h"
+#include "BlueprintActionDatabaseRegistrar.h"
+#include "BlueprintNodeSpawner.h"
+#include "EdGraphSchema_K2.h"
+#include "K2Node_CallFunction.h"
+#include "KismetCompiler.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "Kismet2/CompilerResultsLog.h"
+
+#define LOCTEXT_NAMESPACE "K2Node_BreakGameEvent"
+
+const FName UK2Node_BreakGameEvent::s_eventPinName(TEXT("Event"));
+
+void UK2Node_BreakGameEvent::AllocateDefaultPins()
+{
+	CreatePin(EGPD_Input, UEdGraphSchema_K2::PC_Object, UGameEvent::StaticClass(), s_eventPinName);
+
+	// One pin per argument, named after it. Custom structs get no pin, validation reports them.
+	if (const FEventDefinition* definition = FindDefinition())
+	{
+		for (const TPair<FName, EEventArgTypes>& arg : definition->m_args)
+		{
+			FEdGraphPinType pinType;
+			if (UK2Node_BroadcastGameEvent::GetPinType(arg.Value, pinType))
+				CreatePin(EGPD_Output, pinType, arg.Key);
+		}
+	}
+
+	Super::AllocateDefaultPins();
+}
+
+FText UK2Node_BreakGameEvent::GetNodeTitle(ENodeTitleType::Type titleType) const
+{
+	if (m_event.RowName.IsNone())
+		return LOCTEXT("TitleNoEvent", "Break Game Event");
+
+	return FText::Format(LOCTEXT("Title", "Break {0}"), FText::FromName(m_event.RowName));
+}
+
+FText UK2Node_BreakGameEvent::GetTooltipText() const
+{
+	return LOCTEXT("Tooltip", "Reads the arguments of a game event. Pick the event in the details panel, its arguments become output pins.");
+}
+
+void UK2Node_BreakGameEvent::PostEditChangeProperty(FPropertyChangedEvent& propertyChangedEvent)
+{
+	Super::PostEditChangeProperty(propertyChangedEvent);
+
+	// Picking another event or table changes the pins.
+	ReconstructNode();
+	FBlueprintEditorUtils::MarkBlueprintAsModified(GetBlueprint());
+}
+
+void UK2Node_BreakGameEvent::ValidateNodeDuringCompilation(FCompilerResultsLog& messageLog) const
+{
+	Super::ValidateNodeDuringCompilation(messageLog);
+
+	const FEventDefinition* definition = FindDefinition();
+	if (definition == nullptr)
+	{
+		messageLog.Error(*LOCTEXT("NoEvent", "@@ doesn't point to an existing event, pick one in the details panel.").ToString(), this);
+		return;
+	}
+
+	if (GetEventPin()->LinkedTo.Num() == 0)
+		messageLog.Error(*LOCTEXT("NoEventPin", "@@ needs an event, connect the Event pin.").ToString(), this);
+
+	for (const TPair<FName, EEventArgTypes>& arg : definition->m_args)
+	{
+		FEdGraphPinType pinType;
+		if (!UK2Node_BroadcastGameEvent::GetPinType(arg.Value, pinType))
+		{
+			messageLog.Warning(*FText::Format(LOCTEXT("UnsupportedArg", "@@: argument '{0}' is a custom struct, those can't be read from blueprints."), FText::FromName(arg.Key)).ToString(), this);
+			continue;
+		}
+
+		// The table might have been edited since the node was placed.
+		const UEdGraphPin* pin = FindPin(arg.Key, EGPD_Output);
+		if (pin == nullptr || pin->PinType != pinType)
+			messageLog.Error(*FText::Format(LOCTEXT("StaleArg", "@@: argument '{0}' doesn't match the table anymore, refresh the node."), FText::FromName(arg.Key)).ToString(), this);
+	}
+}
+
+bool UK2Node_BreakGameEvent::IsNodePure() const
+{
+	return true;
+}
+
+void UK2Node_BreakGameEvent::ExpandNode(FKismetCompilerContext& compilerContext, UEdGraph* sourceGraph)
+{
+	Super::ExpandNode(compilerContext, sourceGraph);
+
+	const FEventDefinition* definition = FindDefinition();
+	if (definition == nullptr)
+	{
+		BreakAllNodeLinks();
+		return;
+	}
+
+	// One call per connected pin. The index is the argument's position in the table, custom structs included,
+	// which is the order the event stores its arguments in.
+	UEdGraphPin* eventPin = GetEventPin();
+	int32 index = 0;
+	for (const TPair<FName, EEventArgTypes>& arg : definition->m_args)
+	{
+		const int32 argIndex = index++;
+		UEdGraphPin* argPin = FindPin(arg.Key, EGPD_Output);
+		if (argPin == nullptr || argPin->LinkedTo.Num() == 0)
+			continue;
+
+		UK2Node_CallFunction* callNode = compilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(this, sourceGraph);
+		callNode->FunctionReference.SetExternalMember(GET_FUNCTION_NAME_CHECKED(UGameEvent, GetValueAt), UGameEvent::StaticClass());
+		callNode->AllocateDefaultPins();
+
+		compilerContext.CopyPinLinksToIntermediate(*eventPin, *callNode->FindPinChecked(UEdGraphSchema_K2::PN_Self));
+		callNode->FindPinChecked(TEXT("index"))->DefaultValue = FString::FromInt(argIndex);
+		callNode->FindPinChecked(TEXT("id"))->DefaultValue = arg.Key.ToString();
+
+		// The value pin is a wildcard, it takes the type of the argument.
+		UEdGraphPin* valuePin = callNode->FindPinChecked(TEXT("value"));
+		valuePin->PinType = argPin->PinType;
+		compilerContext.MovePinLinksToIntermediate(*argPin, *valuePin);
+	}
+
+	BreakAllNodeLinks();
+}
+
+void UK2Node_BreakGameEvent::GetMenuActions(FBlueprintActionDatabaseRegistrar& actionRegistrar) const
+{
+	UClass* actionKey = GetClass();
+	if (actionRegistrar.IsOpenForRegistration(actionKey))
+	{
+		UBlueprintNodeSpawner* nodeSpawner = UBlueprintNodeSpawner::Create(GetClass());
+		check(nodeSpawner != nullptr);
+		actionRegistrar.AddBlueprintAction(actionKey, nodeSpawner);
+	}
+}
+
+FText UK2Node_BreakGameEvent::GetMenuCategory() const
+{
+	return LOCTEXT("MenuCategory", "Game Events");
+}
+
+const FEventDefinition* UK2Node_BreakGameEvent::FindDefinition() const
+{
+	if (m_event.DataTable == nullptr || m_event.RowName.IsNone())
+		return nullptr;
+
+	return m_event.DataTable->FindRow<FEventDefinition>(m_event.RowName, TEXT("UK2Node_BreakGameEvent"), false);
+}
+
+UEdGraphPin* UK2Node_BreakGameEvent::GetEventPin() const
+{
+	return FindPinChecked(s_eventPinName);
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,75 @@
+/*
+* @author: Inan Evin
+* @website: www.inanevin.com
+* @twitter: lineupthesky
+* @github: https://github.com/inanevin/UE-DataTable-Based-Event-Manager
+* 
+* Simple Event Manager, exposed to UE4 Editor via DataTables.
+*
+* MIT License
+* Copyright (c) 2021 Inan Evin
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+* 
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "K2Node.h"
+#include "Engine/DataTable.h"
+#include "Core/GameEventManager.h"
+#include "K2Node_BreakGameEvent.generated.h"
+
+/**
+* Blueprint node reading the arguments of a game event, with one typed output pin per argument.
+* The event is picked in the details panel like on UK2Node_BroadcastGameEvent, the pins are checked against the DataTable while the blueprint is compiled.
+* Every connected pin compiles down to a single call to UGameEvent::GetValueAt(), which copies the argument straight into the pin.
+* Editor only, it needs to live in an editor module, see the README.
+*/
+UCLASS()
+class PROJECTSNIPEREDITOR_API UK2Node_BreakGameEvent : public UK2Node
+{
+	GENERATED_BODY()
+
+public:
+	// UEdGraphNode
+	virtual void AllocateDefaultPins() override;
+	virtual FText GetNodeTitle(ENodeTitleType::Type titleType) const override;
+	virtual FText GetTooltipText() const override;
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& propertyChangedEvent) override;
+	virtual void ValidateNodeDuringCompilation(class FCompilerResultsLog& messageLog) const override;
+
+	// UK2Node
+	virtual bool IsNodePure() const override;
+	virtual void ExpandNode(class FKismetCompilerContext& compilerContext, UEdGraph* sourceGraph) override;
+	virtual void GetMenuActions(FBlueprintActionDatabaseRegistrar& actionRegistrar) const override;
+	virtual FText GetMenuCategory() const override;
+
+private:
+	const FEventDefinition* FindDefinition() const;
+	UEdGraphPin* GetEventPin() const;
+
+private:
+	/// Event table and the row of the event to read.
+	UPROPERTY(EditAnywhere, Category = "Event", meta = (RowType = "EventDefinition"))
+	FDataTableRowHandle m_event;
+
+	static const FName s_eventPinName;
+};
@@ -0,0 +1,230 @@
+/*
+* @author: Inan Evin
+* @website: www.inanevin.com
+* @twitter: lineupthesky
+* @github: https://github.com/inanevin/UE-DataTable-Based-Event-Manager
+* 
+* Simple Event Manager, exposed to UE4 Editor via DataTables.
+*
+* MIT License
+* Copyright (c) 2021 Inan Evin
+* 
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+* 
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+* 
+*/
+
+#include "K2Node_BroadcastGameEvent.h"
+#include "GameFramework/Actor.h"
+#include "BlueprintActionDatabaseRegistrar.h"
+#include "BlueprintNodeSpawner.h"
+#include "EdGraphSchema_K2.h"
+#include "K2Node_CallFunction.h"
+#include "KismetCompiler.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "Kismet2/CompilerResultsLog.h"
+
+#define LOCTEXT_NAMESPACE "K2Node_BroadcastGameEvent"
+
+const FName UK2Node_BroadcastGameEvent::s_managerPinName(TEXT("Manager"));
+
+void UK2Node_BroadcastGameEvent::AllocateDefaultPins()
+{
+	CreatePin(EGPD_Input, UEdGraphSchema_K2::PC_Exec, UEdGraphSchema_K2::PN_Execute);
+	CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Exec, UEdGraphSchema_K2::PN_Then);
+	CreatePin(EGPD_Input, UEdGraphSchema_K2::PC_Object, UGameEventManager::StaticClass(), s_managerPinName);
+
+	// One pin per argument, in the order of the table, which is the order Broadcast() expects them in.
+	// Without an event the node only has its fixed pins, the base class still has to run.
+	if (const FEventDefinition* definition = FindDefinition())
+	{
+		for (const TPair<FName, EEventArgTypes>& arg : definition->m_args)
+		{
+			FEdGraphPinType pinType;
+			if (GetPinType(arg.Value, pinType))
+				CreatePin(EGPD_Input, pinType, arg.Key);
+		}
+	}
+
+	Super::AllocateDefaultPins();
+}
+
+FText UK2Node_BroadcastGameEvent::GetNodeTitle(ENodeTitleType::Type titleType) const
+{
+	if (m_event.RowName.IsNone())
+		return LOCTEXT("TitleNoEvent", "Broadcast Game Event");
+
+	return FText::Format(LOCTEXT("Title", "Broadcast {0}"), FText::FromName(m_event.RowName));
+}
+
+FText UK2Node_BroadcastGameEvent::GetTooltipText() const
+{
+	return LOCTEXT("Tooltip", "Broadcasts a game event. Pick the event in the details panel, its arguments become input pins.");
+}
+
+void UK2Node_BroadcastGameEvent::PostEditChangeProperty(FPropertyChangedEvent& propertyChangedEvent)
+{
+	Super::PostEditChangeProperty(propertyChangedEvent);
+
+	// Picking another event or table changes the pins.
+	ReconstructNode();
+	FBlueprintEditorUtils::MarkBlueprintAsModified(GetBlueprint());
+}
+
+void UK2Node_BroadcastGameEvent::ValidateNodeDuringCompilation(FCompilerResultsLog& messageLog) const
+{
+	Super::ValidateNodeDuringCompilation(messageLog);
+
+	const FEventDefinition* definition = FindDefinition();
+	if (definition == nullptr)
+	{
+		messageLog.Error(*LOCTEXT("NoEvent", "@@ doesn't point to an existing event, pick one in the details panel.").ToString(), this);
+		return;
+	}
+
+	for (const TPair<FName, EEventArgTypes>& arg : definition->m_args)
+	{
+		FEdGraphPinType pinType;
+		if (!GetPinType(arg.Value, pinType))
+		{
+			messageLog.Error(*FText::Format(LOCTEXT("UnsupportedArg", "@@: argument '{0}' is a custom struct, those can't be sent from blueprints."), FText::FromName(arg.Key)).ToString(), this);
+			continue;
+		}
+
+		// The table might have been edited since the node was placed.
+		const UEdGraphPin* pin = FindPin(arg.Key, EGPD_Input);
+		if (pin == nullptr || pin->PinType != pinType)
+			messageLog.Error(*FText::Format(LOCTEXT("StaleArg", "@@: argument '{0}' doesn't match the table anymore, refresh the node."), FText::FromName(arg.Key)).ToString(), this);
+	}
+}
+
+void UK2Node_BroadcastGameEvent::ExpandNode(FKismetCompilerContext& compilerContext, UEdGraph* sourceGraph)
+{
+	Super::ExpandNode(compilerContext, sourceGraph);
+
+	const FEventDefinition* definition = FindDefinition();
+	if (definition == nullptr)
+	{
+		BreakAllNodeLinks();
+		return;
+	}
+
+	UK2Node_CallFunction* callNode = compilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(this, sourceGraph);
+	callNode->FunctionReference.SetExternalMember(GET_FUNCTION_NAME_CHECKED(UGameEventManager, BroadcastVariadic), UGameEventManager::StaticClass());
+	callNode->AllocateDefaultPins();
+
+	compilerContext.MovePinLinksToIntermediate(*GetExecPin(), *callNode->GetExecPin());
+	compilerContext.MovePinLinksToIntermediate(*FindPinChecked(UEdGraphSchema_K2::PN_Then), *callNode->GetThenPin());
+	compilerContext.MovePinLinksToIntermediate(*GetManagerPin(), *callNode->FindPinChecked(UEdGraphSchema_K2::PN_Self));
+
+	callNode->FindPinChecked(TEXT("id"))->DefaultValue = m_event.RowName.ToString();
+	callNode->FindPinChecked(TEXT("numArgs"))->DefaultValue = FString::FromInt(definition->m_args.Num());
+
+	// Every argument becomes an extra, typed parameter of the variadic call, in table order.
+	for (const TPair<FName, EEventArgTypes>& arg : definition->m_args)
+	{
+		UEdGraphPin* argPin = FindPin(arg.Key, EGPD_Input);
+		if (argPin == nullptr)
+			continue;
+
+		UEdGraphPin* callPin = callNode->CreatePin(EGPD_Input, argPin->PinType, arg.Key);
+		compilerContext.MovePinLinksToIntermediate(*argPin, *callPin);
+	}
+
+	BreakAllNodeLinks();
+}
+
+void UK2Node_BroadcastGameEvent::GetMenuActions(FBlueprintActionDatabaseRegistrar& actionRegistrar) const
+{
+	UClass* actionKey = GetClass();
+	if (actionRegistrar.IsOpenForRegistration(actionKey))
+	{
+		UBlueprintNodeSpawner* nodeSpawner = UBlueprintNodeSpawner::Create(GetClass());
+		check(nodeSpawner != nullptr);
+		actionRegistrar.AddBlueprintAction(actionKey, nodeSpawner);
+	}
+}
+
+FText UK2Node_BroadcastGameEvent::GetMenuCategory() const
+{
+	return LOCTEXT("MenuCategory", "Game Events");
+}
+
+const FEventDefinition* UK2Node_BroadcastGameEvent::FindDefinition() const
+{
+	if (m_event.DataTable == nullptr || m_event.RowName.IsNone())
+		return nullptr;
+
+	return m_event.DataTable->FindRow<FEventDefinition>(m_event.RowName, TEXT("UK2Node_BroadcastGameEvent"), false);
+}
+
+UEdGraphPin* UK2Node_BroadcastGameEvent::GetManagerPin() const
+{
+	return FindPinChecked(s_managerPinName);
+}
+
+bool UK2Node_BroadcastGameEvent::GetPinType(EEventArgTypes type, FEdGraphPinType& pinType)
+{
+	switch (type)
+	{
+	case EEventArgTypes::Int:
+		pinType.PinCategory = UEdGraphSchema_K2::PC_Int;
+		return true;
+	case EEventArgTypes::Float:
+		pinType.PinCategory = UEdGraphSchema_K2::PC_Float;
+		return true;
+	case EEventArgTypes::Bool:
+		pinType.PinCategory = UEdGraphSchema_K2::PC_Boolean;
+		return true;
+	case EEventArgTypes::FName:
+		pinType.PinCategory = UEdGraphSchema_K2::PC_Name;
+		return true;
+	case EEventArgTypes::FString:
+		pinType.PinCategory = UEdGraphSchema_K2::PC_String;
+		return true;
+	case EEventArgTypes::FVector:
+		pinType.PinCategory = UEdGraphSchema_K2::PC_Struct;
+		pinType.PinSubCategoryObject = TBaseStructure<FVector>::Get();
+		return true;
+	case EEventArgTypes::FVector2D:
+		pinType.PinCategory = UEdGraphSchema_K2::PC_Struct;
+		pinType.PinSubCategoryObject = TBaseStructure<FVector2D>::Get();
+		return true;
+	case EEventArgTypes::FRotator:
+		pinType.PinCategory = UEdGraphSchema_K2::PC_Struct;
+		pinType.PinSubCategoryObject = TBaseStructure<FRotator>::Get();
+		return true;
+	case EEventArgTypes::UObjectPtr:
+		pinType.PinCategory = UEdGraphSchema_K2::PC_Object;
+		pinType.PinSubCategoryObject = UObject::StaticClass();
+		return true;
+	case EEventArgTypes::AActorPtr:
+		pinType.PinCategory = UEdGraphSchema_K2::PC_Object;
+		pinType.PinSubCategoryObject = AActor::StaticClass();
+		return true;
+	case EEventArgTypes::UEnum:
+		pinType.PinCategory = UEdGraphSchema_K2::PC_Byte;
+		return true;
+	case EEventArgTypes::CustomStruct:
+		break;
+	}
+
+	return false;
+}
+
+#undef LOCTEXT_NAMESPACE
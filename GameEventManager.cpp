@@ -30,107 +30,2813 @@
 */
 
 #include "Core/GameEventManager.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+#include "UObject/EnumProperty.h"
+#include "GameFramework/Actor.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "TimerManager.h"
+#include "Containers/Ticker.h"
 
-void UGameEventManager::Setup()
+static TAutoConsoleVariable<FString> CVarDisabledGameEvents(
+	TEXT("GameEvents.Disabled"),
+	TEXT(""),
+	TEXT("Comma separated list of event names or categories to disable, on top of the ones disabled in the config."),
+	ECVF_Default);
+
+static void OnGameEventConsoleVariablesChanged()
+{
+	// Sinks run whenever any console variable changes, only re-apply if ours did.
+	static FString lastValue;
+	const FString value = CVarDisabledGameEvents.GetValueOnGameThread();
+	if (value == lastValue)
+		return;
+	lastValue = value;
+
+	for (UGameEventManager* manager : TObjectRange<UGameEventManager>())
+		manager->ApplyDisabledEvents();
+}
+
+static FAutoConsoleVariableSink GameEventConsoleVariableSink(FConsoleCommandDelegate::CreateStatic(&OnGameEventConsoleVariablesChanged));
+
+static void DumpGameEventHistory(const TArray<FString>& args)
+{
+	if (args.Num() == 0)
+	{
+		UE_LOG(LogTemp, Display, TEXT("Usage: GameEvents.DumpHistory <EventName>"));
+		return;
+	}
+
+	const FName id(*args[0]);
+	for (UGameEventManager* manager : TObjectRange<UGameEventManager>())
+	{
+		bool found = false;
+		FGameEventHandle handle = manager->ResolveEvent(id, found);
+		if (!found)
+			continue;
+
+		const UGameEvent& ev = manager->Get(handle);
+		const FGameEventHistory* history = ev.GetHistory();
+		if (history == nullptr)
+		{
+			UE_LOG(LogTemp, Display, TEXT("Event '%s' doesn't keep a history, set its History Size in the table."), *id.ToString());
+			continue;
+		}
+
+		const FGameEventPackedLayout& layout = ev.GetPackedLayout();
+		FGameEventHistoryRecord record;
+		for (uint64 number = history->GetFirstNumber(); history->GetRecord(number, record); number++)
+		{
+			FString line = FString::Printf(TEXT("%s #%llu frame %llu time %.3f:"), *id.ToString(), number, record.m_frame, record.m_time);
+			for (int32 i = 0; i < layout.Num(); i++)
+				line += TEXT(" ") + layout.DescribeArg(record.m_args, i);
+			UE_LOG(LogTemp, Display, TEXT("%s"), *line);
+		}
+	}
+}
+
+static FAutoConsoleCommand DumpGameEventHistoryCommand(
+	TEXT("GameEvents.DumpHistory"),
+	TEXT("Logs the recorded broadcasts of an event, oldest first. The event needs a History Size in the table."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&DumpGameEventHistory));
+
+/** Reports the object held by a captured argument to the garbage collector. */
+static void AddReferencedArg(FReferenceCollector& collector, EventArgType& arg)
+{
+	if (arg.IsType<UObject*>())
+		collector.AddReferencedObject(arg.Get<UObject*>());
+	else if (arg.IsType<AActor*>())
+		collector.AddReferencedObject(arg.Get<AActor*>());
+}
+
+static void AddReferencedArgs(FReferenceCollector& collector, TArrayView<EventArgType> args)
+{
+	for (EventArgType& arg : args)
+		AddReferencedArg(collector, arg);
+}
+
+const uint32 UGameEvent::s_alwaysEnabled = ~0u;
+const FGameEventPackedLayout UGameEvent::s_emptyLayout;
+FGameEventAwaiter* UGameEvent::s_orphanedWaiters = nullptr;
+const FIntVector UGameEventManager::OversizedSpatialCell = FIntVector(MAX_int32, MAX_int32, MAX_int32);
+
+void FGameEventNameHash::Build(const TArray<FName>& keys)
+{
+	Reset();
+
+	if (keys.Num() == 0)
+		return;
+
+	// Keys with equal hashes would send the seed search looking forever, only the first one goes into the table.
+	TArray<int32> tableKeys;
+	TSet<uint32> hashes;
+	tableKeys.Reserve(keys.Num());
+	hashes.Reserve(keys.Num());
+	for (int32 i = 0; i < keys.Num(); i++)
+	{
+		bool isCollision = false;
+		hashes.Add(KeyHash(keys[i]), &isCollision);
+		if (isCollision)
+			m_collisions.Emplace(keys[i], i);
+		else
+			tableKeys.Add(i);
+	}
+
+	const int32 num = tableKeys.Num();
+
+	// Around two keys per bucket keeps the seed search short.
+	const uint32 numBuckets = FMath::RoundUpToPowerOfTwo(FMath::Max(1, num / 2));
+	m_bucketMask = numBuckets - 1;
+	m_seeds.SetNumZeroed(numBuckets);
+	m_keys.SetNum(num);
+	m_values.SetNum(num);
+
+	TArray<TArray<int32, TInlineAllocator<4>>> buckets;
+	buckets.SetNum(numBuckets);
+	for (int32 key : tableKeys)
+		buckets[Bucket(KeyHash(keys[key]))].Add(key);
+
+	// Place the biggest buckets first, while there are still plenty of free slots.
+	TArray<int32> order;
+	order.Reserve(numBuckets);
+	for (uint32 i = 0; i < numBuckets; i++)
+		order.Add(i);
+	order.Sort([&buckets](int32 a, int32 b) { return buckets[a].Num() > buckets[b].Num(); });
+
+	TBitArray<> taken(false, num);
+	TArray<int32, TInlineAllocator<4>> slots;
+
+	for (int32 bucket : order)
+	{
+		const TArray<int32, TInlineAllocator<4>>& members = buckets[bucket];
+		if (members.Num() == 0)
+			break;
+
+		// Search for a seed that sends every key of the bucket to a free slot.
+		for (uint32 seed = 1;; seed++)
+		{
+			// Every key in the table has a distinct hash, a seed is always found well before this.
+			checkf(seed < (1u << 24), TEXT("Couldn't build a perfect hash over %d keys."), num);
+
+			slots.Reset();
+			for (int32 key : members)
+			{
+				const int32 slot = Slot(KeyHash(keys[key]), seed);
+				if (taken[slot] || slots.Contains(slot))
+					break;
+				slots.Add(slot);
+			}
+
+			if (slots.Num() == members.Num())
+			{
+				m_seeds[bucket] = seed;
+				for (int32 i = 0; i < members.Num(); i++)
+				{
+					taken[slots[i]] = true;
+					m_keys[slots[i]] = keys[members[i]];
+					m_values[slots[i]] = members[i];
+				}
+				break;
+			}
+		}
+	}
+}
+
+void FGameEventNameHash::Rebuild(const TArray<FName>& keys)
+{
+	bool sameKeys = keys.Num() == Num();
+	for (int32 i = 0; sameKeys && i < keys.Num(); i++)
+		sameKeys = Find(keys[i]) != INDEX_NONE;
+
+	if (!sameKeys)
+	{
+		Build(keys);
+		return;
+	}
+
+	// Same key set, the seeds are still valid. Only the indices they map to might have moved.
+	for (int32 i = 0; i < keys.Num(); i++)
+	{
+		const int32 slot = FindSlot(keys[i]);
+		if (slot != INDEX_NONE)
+		{
+			m_values[slot] = i;
+			continue;
+		}
+
+		for (TPair<FName, int32>& collision : m_collisions)
+		{
+			if (collision.Key == keys[i])
+				collision.Value = i;
+		}
+	}
+}
+
+int32 FGameEventNameHash::FindCollision(const FName& key) const
+{
+	for (const TPair<FName, int32>& collision : m_collisions)
+	{
+		if (collision.Key == key)
+			return collision.Value;
+	}
+	return INDEX_NONE;
+}
+
+void FGameEventNameTrie::Build(const TArray<FGameEventRegistryEntry>& registry)
+{
+	Reset();
+
+	TArray<FString> segments;
+	for (int32 i = 0; i < registry.Num(); i++)
+	{
+		registry[i].m_name.ToString().ParseIntoArray(segments, TEXT("."));
+
+		int32 node = 0;
+		for (const FString& segment : segments)
+		{
+			const FName key(*segment);
+			int32* child = m_nodes[node].m_children.Find(key);
+			if (child != nullptr)
+			{
+				node = *child;
+				continue;
+			}
+
+			const int32 newNode = m_nodes.AddDefaulted();
+			m_nodes[node].m_children.Add(key, newNode);
+			node = newNode;
+		}
+
+		m_nodes[node].m_event = i;
+	}
+}
+
+void FGameEventNameTrie::Reset()
+{
+	m_nodes.Reset();
+	m_nodes.AddDefaulted();
+}
+
+bool FGameEventNameTrie::Match(const FString& pattern, TArray<int32>& outIndices) const
+{
+	if (m_nodes.Num() == 0)
+		return true;
+
+	TArray<FString> segments;
+	pattern.ParseIntoArray(segments, TEXT("."));
+
+	const bool isWildcard = segments.Num() > 0 && segments.Last() == TEXT("*");
+	if (isWildcard)
+		segments.Pop();
+
+	int32 node = 0;
+	for (const FString& segment : segments)
+	{
+		if (segment.Contains(TEXT("*")))
+			return false;
+
+		const int32* child = m_nodes[node].m_children.Find(FName(*segment));
+		if (child == nullptr)
+			return true;
+		node = *child;
+	}
+
+	if (isWildcard)
+		Collect(node, outIndices);
+	else if (m_nodes[node].m_event != INDEX_NONE)
+		outIndices.Add(m_nodes[node].m_event);
+
+	return true;
+}
+
+void FGameEventNameTrie::Collect(int32 node, TArray<int32>& outIndices) const
+{
+	if (m_nodes[node].m_event != INDEX_NONE)
+		outIndices.Add(m_nodes[node].m_event);
+
+	for (const TPair<FName, int32>& child : m_nodes[node].m_children)
+		Collect(child.Value, outIndices);
+}
+
+void FGameEventPackedLayout::Build(const TArray<CEventArg>& args)
 {
-	// List of row names in the datable.
-	TArray<FName> rowNames = m_eventDefinitions->GetRowNames();
+	m_offsets.Reset(args.Num());
+	m_typeIndices.Reset(args.Num());
+	m_size = 0;
 
-	// Iterate each row.
-	for (const FName& name : rowNames)
+	// Values are copied in and out with memcpy, so there's no need for any alignment.
+	for (const CEventArg& arg : args)
 	{
-		FString contextString;
-		FEventDefinition* row = m_eventDefinitions->FindRow<FEventDefinition>(name, contextString);
-		if (row)
+		m_offsets.Add(m_size);
+		m_typeIndices.Add(arg.m_type.GetIndex());
+		m_size += Visit([](const auto& value) -> int32
 		{
+			typedef typename TDecay<decltype(value)>::Type T;
+			if constexpr (TIsSame<T, FString>::Value)
+				return static_cast<int32>(sizeof(FGameEventPackedString));
+			else
+				return static_cast<int32>(sizeof(T));
+		}, arg.m_type);
+	}
+}
 
-			// Create a game event for each row, either a normal one or a dynamic one.
-			UGameEvent* ev = nullptr;
-			if (row->m_isDynamic)
-				ev = NewObject<UGameEventDynamic>(GetOuter(), UGameEventDynamic::StaticClass());
+void FGameEventPackedLayout::Pack(const TArray<CEventArg>& args, uint8* dest) const
+{
+	for (int32 i = 0; i < m_offsets.Num(); i++)
+	{
+		uint8* target = dest + m_offsets[i];
+		Visit([target](const auto& value)
+		{
+			typedef typename TDecay<decltype(value)>::Type T;
+			if constexpr (TIsSame<T, FString>::Value)
+			{
+				FGameEventPackedString str;
+				str.m_len = FMath::Min(value.Len(), FGameEventPackedString::Capacity);
+				FMemory::Memcpy(str.m_chars, *value, str.m_len * sizeof(TCHAR));
+				FMemory::Memcpy(target, &str, sizeof(FGameEventPackedString));
+			}
 			else
-				ev = NewObject<UGameEvent>(GetOuter(), UGameEvent::StaticClass());
-			ev->m_name = name;
-			m_events.Add(name, ev);
-
-			// Iterate all arguments in the row.
-			// For each argument, add a new EventArgType type list to the event arguments array.
-			// These type lists will determine what is the type of the argument for the event, based on the enumeration value set in editor.
-			for (auto& arg : row->m_args)
 			{
-				EventArgType argType;
-				
-				if (arg.Value == EEventArgTypes::Int)
-					argType.Set<int>(0);
-				else if (arg.Value == EEventArgTypes::Float)
-					argType.Set<float>(0);
-				else if (arg.Value == EEventArgTypes::Bool)
-					argType.Set<bool>(0);
-				else if (arg.Value == EEventArgTypes::FName)
-					argType.Set<FName>("");
-				else if (arg.Value == EEventArgTypes::FString)
-					argType.Set<FString>("");
-				else if (arg.Value == EEventArgTypes::FVector)
-					argType.Set<FVector>(FVector::ZeroVector);
-				else if (arg.Value == EEventArgTypes::FVector2D)
-					argType.Set<FVector2D>(FVector2D::ZeroVector);
-				else if (arg.Value == EEventArgTypes::FRotator)
-					argType.Set<FRotator>(FRotator::ZeroRotator);
-				else if (arg.Value == EEventArgTypes::UObjectPtr)
-					argType.Set<UObject*>(nullptr);
-				else if (arg.Value == EEventArgTypes::AActorPtr)
-					argType.Set<AActor*>(nullptr);
-				else if (arg.Value == EEventArgTypes::UEnum)
-					argType.Set<uint8>(0);
-				else if(arg.Value == EEventArgTypes::CustomStruct)
-					argType.Set<FEventArgStruct*>(nullptr);
-
-				ev->m_eventArgs.Add(CEventArg(arg.Key, argType));
+				FMemory::Memcpy(target, &value, sizeof(T));
 			}
+		}, args[i].m_type);
+	}
+}
+
+FString FGameEventPackedLayout::DescribeArg(const uint8* packed, int32 index) const
+{
+	int intValue;
+	float floatValue;
+	double doubleValue;
+	FString stringValue;
+	FName nameValue;
+	bool boolValue;
+	FVector vectorValue;
+	FVector2D vector2DValue;
+	FRotator rotatorValue;
+	UObject* objectValue;
+	AActor* actorValue;
+	uint8 enumValue;
+	FEventArgStruct* structValue;
+
+	if (Read(packed, index, intValue))
+		return FString::FromInt(intValue);
+	if (Read(packed, index, floatValue))
+		return FString::SanitizeFloat(floatValue);
+	if (Read(packed, index, doubleValue))
+		return FString::SanitizeFloat(doubleValue);
+	if (Read(packed, index, stringValue))
+		return stringValue;
+	if (Read(packed, index, nameValue))
+		return nameValue.ToString();
+	if (Read(packed, index, boolValue))
+		return boolValue ? TEXT("true") : TEXT("false");
+	if (Read(packed, index, vectorValue))
+		return vectorValue.ToString();
+	if (Read(packed, index, vector2DValue))
+		return vector2DValue.ToString();
+	if (Read(packed, index, rotatorValue))
+		return rotatorValue.ToString();
+	if (Read(packed, index, objectValue))
+		return FString::Printf(TEXT("%p"), objectValue);
+	if (Read(packed, index, actorValue))
+		return FString::Printf(TEXT("%p"), actorValue);
+	if (Read(packed, index, enumValue))
+		return FString::FromInt(enumValue);
+	if (Read(packed, index, structValue))
+		return FString::Printf(TEXT("%p"), structValue);
+
+	return TEXT("?");
+}
+
+void FGameEventSeqLock::Reset(int32 size)
+{
+	m_size = size;
+	m_data.Reset();
+	m_data.SetNumZeroed(size * 2);
+	m_started.store(0, std::memory_order_relaxed);
+	m_published.store(0, std::memory_order_release);
+}
+
+void FGameEventSeqLock::Write(const FGameEventPackedLayout& layout, const TArray<CEventArg>& args)
+{
+	// Zero is reserved for "never written".
+	uint32 write = m_published.load(std::memory_order_relaxed) + 1;
+	if (write == 0)
+		write = 2;
+
+	m_started.store(write, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	layout.Pack(args, m_data.GetData() + (write & 1) * m_size);
+
+	m_published.store(write, std::memory_order_release);
+}
+
+bool FGameEventSeqLock::Read(uint8* dest) const
+{
+	for (;;)
+	{
+		const uint32 published = m_published.load(std::memory_order_acquire);
+		if (published == 0)
+			return false;
+
+		FMemory::Memcpy(dest, m_data.GetData() + (published & 1) * m_size, m_size);
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		// The buffer we copied is only reused by the write after the next one.
+		if (m_started.load(std::memory_order_relaxed) - published < 2)
+			return true;
+	}
+}
+
+void FGameEventHistory::Reset(int32 capacity, int32 packedSize)
+{
+	// Keep the headers aligned, the packed arguments right after them don't need any alignment.
+	m_capacity = capacity;
+	m_stride = Align(static_cast<int32>(sizeof(FHeader)) + packedSize, static_cast<int32>(alignof(FHeader)));
+	m_numRecorded = 0;
+	m_data.Reset();
+	m_data.SetNumZeroed(m_capacity * m_stride);
+}
+
+void FGameEventHistory::Record(const FGameEventPackedLayout& layout, const TArray<CEventArg>& args)
+{
+	uint8* slot = m_data.GetData() + static_cast<int32>(m_numRecorded % m_capacity) * m_stride;
+
+	FHeader* header = reinterpret_cast<FHeader*>(slot);
+	header->m_frame = GFrameCounter;
+	header->m_time = FPlatformTime::Seconds();
+	layout.Pack(args, slot + sizeof(FHeader));
+
+	m_numRecorded++;
+}
+
+bool FGameEventHistory::GetRecord(uint64 number, FGameEventHistoryRecord& outRecord) const
+{
+	if (number >= m_numRecorded || number < GetFirstNumber())
+		return false;
+
+	const uint8* slot = m_data.GetData() + static_cast<int32>(number % m_capacity) * m_stride;
+	const FHeader* header = reinterpret_cast<const FHeader*>(slot);
+	outRecord.m_frame = header->m_frame;
+	outRecord.m_time = header->m_time;
+	outRecord.m_args = slot + sizeof(FHeader);
+	return true;
+}
+
+void FGameEventNameHash::Reset()
+{
+	m_seeds.Reset();
+	m_keys.Reset();
+	m_values.Reset();
+	m_bucketMask = 0;
+	m_collisions.Reset();
+}
+
+UGameEventManager::UGameEventManager()
+{
+	for (int32& slot : m_timerSlots)
+		slot = INDEX_NONE;
+}
+
+void UGameEventManager::Setup()
+{
+	// The registry is baked whenever the manager is saved or cooked.
+#if WITH_EDITOR
+	// In the editor the table can be edited without resaving the manager, and an edited row can keep the row count.
+	// PIE instances are created from the blueprint's defaults and copy their registry. The defaults watch the table,
+	// so the table is only walked again after it was edited, instead of in every session.
+	UGameEventManager* defaults = GetClass()->GetDefaultObject<UGameEventManager>();
+	if (defaults != this && defaults->m_eventDefinitions == m_eventDefinitions)
+	{
+		if (defaults->IsRegistryStale())
+		{
+			defaults->BuildRegistry();
+			m_registry = defaults->m_registry;
+			m_registryArgNames = defaults->m_registryArgNames;
+			m_registryArgTypes = defaults->m_registryArgTypes;
 		}
 	}
+	else if (IsRegistryStale())
+	{
+		BuildRegistry();
+	}
+#else
+	// Only fall back to walking the DataTable if it's missing or obviously out of date.
+	if (m_eventDefinitions && m_registry.Num() != m_eventDefinitions->GetRowMap().Num())
+		BuildRegistry();
+#endif
+
+	BuildEventHash();
+	m_events.Reset();
+	m_events.SetNumZeroed(m_registry.Num());
+	ApplyDisabledEvents();
 
+#if WITH_EDITOR
+	// Designers edit the table while the game is running, pick those edits up without dropping any bindings.
+	if (m_eventDefinitions && !m_tableChangedHandle.IsValid())
+		m_tableChangedHandle = m_eventDefinitions->OnDataTableChanged().AddUObject(this, &UGameEventManager::Reload);
+#endif
+
+	// Lazy events are materialized on first use. Events storing their latest value are always created here,
+	// so other threads reading them never race with a lazy instantiation.
+	for (int32 i = 0; i < m_registry.Num(); i++)
+	{
+		if (!m_lazyInstantiation || m_registry[i].m_isLatched || m_registry[i].m_publishLatest)
+			InstantiateEvent(i);
+	}
 }
 
-void UGameEventManager::Clear()
+void UGameEventManager::Reload()
 {
-	m_events.Empty();
+	// Keep the old lookup around until every live event found its new place in the registry.
+	TArray<UGameEvent*> oldEvents = MoveTemp(m_events);
+	const FGameEventNameHash oldHash = m_eventHash;
+
+	BuildRegistry();
+	BuildEventHash();
+	m_events.SetNumZeroed(m_registry.Num());
+
+	// Instantiating links the enable bit, so the mask has to cover the new registry before any event is created.
+	// Surviving events keep pointing into the old words until they are relinked below.
+	m_enabledMask.SetNumUninitialized(FMath::DivideAndRoundUp(m_registry.Num(), 32));
+
+	for (int32 i = 0; i < m_registry.Num(); i++)
+	{
+		const FGameEventRegistryEntry& entry = m_registry[i];
+		const int32 oldIndex = oldHash.Find(entry.m_name);
+		UGameEvent* ev = oldIndex != INDEX_NONE ? oldEvents[oldIndex] : nullptr;
+
+		if (ev == nullptr)
+		{
+			// New row. Lazy events will be created on first use anyways.
+			if (!m_lazyInstantiation || entry.m_isLatched || entry.m_publishLatest)
+				InstantiateEvent(i);
+			continue;
+		}
+
+		oldEvents[oldIndex] = nullptr;
+
+		if (ev->m_isDynamic != entry.m_isDynamic)
+		{
+			// The class of the event changes, so we need a new object. The listener list can be carried over, bindings of m_dynamicDelegate can't.
+			UE_LOG(LogTemp, Warning, TEXT("Event '%s' changed its dynamic flag during reload, bindings of its dynamic delegate are dropped."), *entry.m_name.ToString());
+
+			UGameEvent* newEv = InstantiateEvent(i);
+			newEv->m_listeners = MoveTemp(ev->m_listeners);
+			newEv->m_delegate = MoveTemp(ev->m_delegate);
+			newEv->TakeWaiters(*ev);
+			RebindSpatialListeners(ev, newEv);
+			UnlinkEnableBit(*ev);
+			continue;
+		}
+
+		m_events[i] = ev;
+		MigrateEvent(*ev, entry);
+	}
+
+	// Whatever is left belongs to rows that are gone.
+	for (UGameEvent* ev : oldEvents)
+	{
+		if (ev != nullptr)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Event '%s' was removed from the table during reload, its listeners are dropped."), *ev->m_name.ToString());
+			RebindSpatialListeners(ev, nullptr);
+			UnlinkEnableBit(*ev);
+		}
+	}
+
+	// Indices moved, every live event is relinked to its new bit and the mask is rebuilt from scratch.
+	for (int32 i = 0; i < m_events.Num(); i++)
+	{
+		if (m_events[i] != nullptr)
+			LinkEnableBit(*m_events[i], i);
+	}
+	ApplyDisabledEvents();
+
+	// New rows might match existing wildcard subscriptions.
+	ApplyWildcardListeners();
+
+	// Coroutines waiting on removed rows run last, once the manager is consistent again.
+	for (UGameEvent* ev : oldEvents)
+	{
+		if (ev != nullptr)
+			ev->CancelWaiters();
+	}
 }
 
-UGameEventDynamic* UGameEventManager::GetDynamic(FName id, bool& success)
+void UGameEventManager::MigrateEvent(UGameEvent& ev, const FGameEventRegistryEntry& entry)
 {
-	if(!m_events.Contains(id))
+	// Build the new layout, keeping the current value of every argument that survived with the same name and type.
+	TArray<CEventArg> args;
+	args.Reserve(entry.m_numArgs);
+
+	for (int32 i = entry.m_firstArg; i < entry.m_firstArg + entry.m_numArgs; i++)
 	{
-		success = false;
-		return nullptr;
+		const FName& name = m_registryArgNames[i];
+		EventArgType value = MakeDefaultArg(m_registryArgTypes[i]);
+
+		const int32 oldIndex = ev.m_argHash.Find(name);
+		if (oldIndex != INDEX_NONE && ev.m_eventArgs[oldIndex].m_type.GetIndex() == value.GetIndex())
+			value = ev.m_eventArgs[oldIndex].m_type;
+
+		args.Add(CEventArg(name, value));
 	}
-	
-	success = true;
-	return static_cast<UGameEventDynamic*>(m_events[id]);
+
+	ev.m_eventArgs = MoveTemp(args);
+	ev.m_isLatched = entry.m_isLatched;
+	ev.m_storesLatest = entry.m_isLatched || entry.m_publishLatest;
+	ev.m_historySize = entry.m_historySize;
+	ev.m_locationArgName = entry.m_locationArg;
+	ev.m_priority = entry.m_priority;
+	ev.BuildArgLookups();
 }
 
-UGameEvent& UGameEventManager::Get(const FName& id)
+void UGameEventManager::BuildEventHash()
 {
-	UGameEvent** ev = m_events.Find(id);
-	check(ev != nullptr);
-	return **ev;
+	TArray<FName> names;
+	names.Reserve(m_registry.Num());
+	for (const FGameEventRegistryEntry& entry : m_registry)
+		names.Add(entry.m_name);
+
+	// On reloads the set of names is usually the same, in which case the hash only gets its values remapped.
+	m_eventHash.Rebuild(names);
+	m_eventTrie.Build(m_registry);
 }
 
-void UGameEvent::CheckArgsCounter()
+void UGameEventManager::BuildRegistry()
 {
-	m_argsCounter++;
-	if (m_argsCounter >= m_eventArgs.Num())
+	m_registry.Reset();
+	m_registryArgNames.Reset();
+	m_registryArgTypes.Reset();
+
+#if WITH_EDITOR
+	WatchTable();
+#endif
+
+	if (m_eventDefinitions == nullptr)
+		return;
+
+	// The rows are read as FEventDefinition below, FindRow() used to check this.
+	const UScriptStruct* rowStruct = m_eventDefinitions->GetRowStruct();
+	if (rowStruct == nullptr || !rowStruct->IsChildOf(FEventDefinition::StaticStruct()))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Can't build the event registry, the rows of table '%s' aren't EventDefinitions."), *m_eventDefinitions->GetName());
+		return;
+	}
+
+	// Iterate the row map directly instead of GetRowNames() + FindRow(), which does another lookup per row.
+	const TMap<FName, uint8*>& rowMap = m_eventDefinitions->GetRowMap();
+	m_registry.Reserve(rowMap.Num());
+
+	for (const TPair<FName, uint8*>& pair : rowMap)
 	{
-		BroadcastDelegate();
+		const FEventDefinition* row = reinterpret_cast<const FEventDefinition*>(pair.Value);
+		if (row == nullptr)
+			continue;
+
+		FGameEventRegistryEntry& entry = m_registry.AddDefaulted_GetRef();
+		entry.m_name = pair.Key;
+		entry.m_isDynamic = row->m_isDynamic;
+		entry.m_category = row->m_category;
+		entry.m_isLatched = row->m_isLatched;
+		entry.m_publishLatest = row->m_publishLatest;
+		entry.m_historySize = FMath::Max(row->m_historySize, 0);
+		entry.m_locationArg = row->m_locationArg;
+		entry.m_priority = row->m_priority;
+		entry.m_firstArg = m_registryArgNames.Num();
+		entry.m_numArgs = row->m_args.Num();
+
+		// Arguments keep the order they are defined in the row, Broadcast() relies on it.
+		for (const TPair<FName, EEventArgTypes>& arg : row->m_args)
+		{
+			m_registryArgNames.Add(arg.Key);
+			m_registryArgTypes.Add(arg.Value);
+		}
 	}
 }
 
-void UGameEvent::BroadcastDelegate()
+UGameEvent* UGameEventManager::FindOrInstantiate(const FName& id)
 {
-	m_delegate.Broadcast(*this);
+	return FindOrInstantiate(m_eventHash.Find(id));
+}
+
+UGameEvent* UGameEventManager::FindOrInstantiate(FGameEventHandle& handle)
+{
+	// A reload might have moved the event to another index, in that case look it up by name again.
+	if (!m_registry.IsValidIndex(handle.m_index) || m_registry[handle.m_index].m_name != handle.m_name)
+		handle.m_index = m_eventHash.Find(handle.m_name);
+
+	return FindOrInstantiate(handle.m_index);
+}
+
+UGameEvent* UGameEventManager::FindOrInstantiate(int32 index)
+{
+	if (index == INDEX_NONE)
+		return nullptr;
+
+	// Only lazy events can be missing here. Materializing happens once per event, and like the rest of the manager on the game thread.
+	UGameEvent* ev = m_events[index];
+	if (ev == nullptr)
+		ev = InstantiateEvent(index);
+
+	return ev;
+}
+
+UGameEvent* UGameEventManager::InstantiateEvent(int32 index)
+{
+	const FGameEventRegistryEntry& entry = m_registry[index];
+
+	// Create a game event for each row, either a normal one or a dynamic one.
+	UGameEvent* ev = nullptr;
+	if (entry.m_isDynamic)
+		ev = NewObject<UGameEventDynamic>(GetOuter(), UGameEventDynamic::StaticClass());
+	else
+		ev = NewObject<UGameEvent>(GetOuter(), UGameEvent::StaticClass());
+	ev->m_name = entry.m_name;
+	ev->m_isDynamic = entry.m_isDynamic;
+	ev->m_isLatched = entry.m_isLatched;
+	ev->m_storesLatest = entry.m_isLatched || entry.m_publishLatest;
+	ev->m_historySize = entry.m_historySize;
+	ev->m_locationArgName = entry.m_locationArg;
+	ev->m_priority = entry.m_priority;
+	ev->m_manager = this;
+	m_events[index] = ev;
+	LinkEnableBit(*ev, index);
+
+	// For each argument, add a new EventArgType type list to the event arguments array.
+	// These type lists will determine what is the type of the argument for the event, based on the enumeration value set in editor.
+	ev->m_eventArgs.Reserve(entry.m_numArgs);
+	for (int32 i = entry.m_firstArg; i < entry.m_firstArg + entry.m_numArgs; i++)
+		ev->m_eventArgs.Add(CEventArg(m_registryArgNames[i], MakeDefaultArg(m_registryArgTypes[i])));
+	ev->BuildArgLookups();
+
+	return ev;
+}
+
+void UGameEventManager::BroadcastVariadic(FName id, int32 numArgs)
+{
+	// Only ever called through execBroadcastVariadic, the variadic arguments can't be read outside of the thunk.
+	check(0);
+}
+
+DEFINE_FUNCTION(UGameEventManager::execBroadcastVariadic)
+{
+	P_GET_PROPERTY(FNameProperty, id);
+	P_GET_PROPERTY(FIntProperty, numArgs);
+
+	UGameEvent* ev = P_THIS->FindOrInstantiate(id);
+
+	// The node validated the pins against the table at compile time. All that can go wrong here is the table
+	// being edited after the blueprint was compiled, which the argument count and the per-argument writes catch.
+	bool valid = ev != nullptr && numArgs == ev->m_eventArgs.Num();
+	if (ev == nullptr)
+		UE_LOG(LogTemp, Error, TEXT("Broadcast of event '%s' from blueprint failed, the event doesn't exist."), *id.ToString());
+	else if (!valid)
+		UE_LOG(LogTemp, Error, TEXT("Broadcast of event '%s' from blueprint failed, recompile the blueprint. Got %d arguments but the table defines %d."), *id.ToString(), numArgs, ev->m_eventArgs.Num());
+
+	// Skip the writes for disabled or unobserved events, but the values still have to be stepped over.
+	const bool write = valid && ev->IsEnabled() && ev->NeedsValues();
+
+	// The pins compile to terms of the calling frame, their addresses stay valid for the whole call.
+	TArray<TPair<const FProperty*, const void*>, TInlineAllocator<8>> values;
+	values.Reserve(numArgs);
+	for (int32 i = 0; i < numArgs; i++)
+	{
+		Stack.MostRecentProperty = nullptr;
+		Stack.MostRecentPropertyAddress = nullptr;
+		Stack.StepCompiledIn<FProperty>(nullptr);
+		values.Emplace(Stack.MostRecentProperty, Stack.MostRecentPropertyAddress);
+	}
+
+	P_FINISH;
+
+	// Like Broadcast(), validate every argument before writing any, so a mismatch leaves the previous values intact.
+	for (int32 i = 0; write && i < numArgs; i++)
+	{
+		if (values[i].Value == nullptr || !ev->AcceptsProperty(i, values[i].Key))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Broadcast of event '%s' from blueprint failed, recompile the blueprint. Argument '%s' has the wrong type."), *id.ToString(), *ev->m_eventArgs[i].m_name.ToString());
+			valid = false;
+			break;
+		}
+	}
+
+	for (int32 i = 0; write && valid && i < numArgs; i++)
+		ev->SetValueFromProperty(i, values[i].Key, values[i].Value);
+
+	P_NATIVE_BEGIN;
+	if (write && valid)
+		ev->BroadcastDelegate();
+	P_NATIVE_END;
 }
 
-void UGameEventDynamic::BroadcastDelegate()
+void UGameEventManager::SetEventEnabled(FName id, bool enabled)
 {
-	m_dynamicDelegate.Broadcast(this);
+	const int32 index = m_eventHash.Find(id);
+	if (index == INDEX_NONE)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Can't enable/disable event '%s', it doesn't exist."), *id.ToString());
+		return;
+	}
+
+	SetEnabledBit(index, enabled);
+	AddEnableOverride(id, false, enabled);
 }
+
+void UGameEventManager::SetCategoryEnabled(FName category, bool enabled)
+{
+	SetCategoryBits(category, enabled);
+	AddEnableOverride(category, true, enabled);
+}
+
+void UGameEventManager::ResetEnableOverrides()
+{
+	m_enableOverrides.Reset();
+	ApplyDisabledEvents();
+}
+
+void UGameEventManager::SetCategoryBits(const FName& category, bool enabled)
+{
+	for (int32 i = 0; i < m_registry.Num(); i++)
+	{
+		if (m_registry[i].m_category == category)
+			SetEnabledBit(i, enabled);
+	}
+}
+
+void UGameEventManager::AddEnableOverride(const FName& name, bool isCategory, bool enabled)
+{
+	// Only the last call per name counts, but the order between names matters: an event enabled after its category was disabled stays enabled.
+	m_enableOverrides.RemoveAll([&name, isCategory](const FGameEventEnableOverride& entry) { return entry.m_name == name && entry.m_isCategory == isCategory; });
+	m_enableOverrides.Add({ name, isCategory, enabled });
+}
+
+bool UGameEventManager::IsEventEnabled(FName id) const
+{
+	const int32 index = m_eventHash.Find(id);
+	return index != INDEX_NONE && (m_enabledMask[index / 32] & (1u << (index % 32))) != 0;
+}
+
+void UGameEventManager::ApplyDisabledEvents()
+{
+	const int32 numWords = FMath::DivideAndRoundUp(m_registry.Num(), 32);
+	if (m_enabledMask.Num() != numWords)
+	{
+		m_enabledMask.SetNumUninitialized(numWords);
+
+		// The mask moved, live events need to point to the new words.
+		for (int32 i = 0; i < m_events.Num(); i++)
+		{
+			if (m_events[i] != nullptr)
+				LinkEnableBit(*m_events[i], i);
+		}
+	}
+
+	FMemory::Memset(m_enabledMask.GetData(), 0xFF, numWords * sizeof(uint32));
+
+	for (const FName& name : m_disabledEvents)
+		SetEnabledByName(name, false);
+
+	TArray<FString> cvarNames;
+	CVarDisabledGameEvents.GetValueOnGameThread().ParseIntoArray(cvarNames, TEXT(","), true);
+	for (const FString& name : cvarNames)
+		SetEnabledByName(FName(*name.TrimStartAndEnd()), false);
+
+	// Runtime calls win over the config and the console variable. Events removed by a reload are skipped silently.
+	for (const FGameEventEnableOverride& entry : m_enableOverrides)
+	{
+		if (entry.m_isCategory)
+		{
+			SetCategoryBits(entry.m_name, entry.m_enabled);
+		}
+		else
+		{
+			const int32 index = m_eventHash.Find(entry.m_name);
+			if (index != INDEX_NONE)
+				SetEnabledBit(index, entry.m_enabled);
+		}
+	}
+}
+
+void UGameEventManager::LinkEnableBit(UGameEvent& ev, int32 index)
+{
+	ev.m_enabledWord = &m_enabledMask[index / 32];
+	ev.m_enabledBit = 1u << (index % 32);
+}
+
+void UGameEventManager::UnlinkEnableBit(UGameEvent& ev)
+{
+	ev.m_enabledWord = &UGameEvent::s_alwaysEnabled;
+	ev.m_enabledBit = 1;
+}
+
+void UGameEventManager::SetEnabledBit(int32 index, bool enabled)
+{
+	if (enabled)
+		m_enabledMask[index / 32] |= 1u << (index % 32);
+	else
+		m_enabledMask[index / 32] &= ~(1u << (index % 32));
+}
+
+void UGameEventManager::SetEnabledByName(const FName& nameOrCategory, bool enabled)
+{
+	const int32 index = m_eventHash.Find(nameOrCategory);
+	if (index != INDEX_NONE)
+		SetEnabledBit(index, enabled);
+
+	SetCategoryBits(nameOrCategory, enabled);
+}
+
+EventArgType UGameEventManager::MakeDefaultArg(EEventArgTypes type)
+{
+	EventArgType argType;
+
+	switch (type)
+	{
+	case EEventArgTypes::Int:
+		argType.Set<int>(0);
+		break;
+	case EEventArgTypes::Float:
+		argType.Set<float>(0);
+		break;
+	case EEventArgTypes::Bool:
+		argType.Set<bool>(0);
+		break;
+	case EEventArgTypes::FName:
+		argType.Set<FName>("");
+		break;
+	case EEventArgTypes::FString:
+		argType.Set<FString>("");
+		break;
+	case EEventArgTypes::FVector:
+		argType.Set<FVector>(FVector::ZeroVector);
+		break;
+	case EEventArgTypes::FVector2D:
+		argType.Set<FVector2D>(FVector2D::ZeroVector);
+		break;
+	case EEventArgTypes::FRotator:
+		argType.Set<FRotator>(FRotator::ZeroRotator);
+		break;
+	case EEventArgTypes::UObjectPtr:
+		argType.Set<UObject*>(nullptr);
+		break;
+	case EEventArgTypes::AActorPtr:
+		argType.Set<AActor*>(nullptr);
+		break;
+	case EEventArgTypes::UEnum:
+		argType.Set<uint8>(0);
+		break;
+	case EEventArgTypes::CustomStruct:
+		argType.Set<FEventArgStruct*>(nullptr);
+		break;
+	}
+
+	return argType;
+}
+
+#if WITH_EDITOR
+void UGameEventManager::PreSave(const ITargetPlatform* targetPlatform)
+{
+	Super::PreSave(targetPlatform);
+
+	// Covers both saving the blueprint and cooking, so packaged builds always ship an up to date registry.
+	BuildRegistry();
+}
+
+bool UGameEventManager::IsRegistryStale() const
+{
+	return m_eventDefinitions != nullptr && (m_isRegistryStale || m_watchedTable.Get() != m_eventDefinitions || m_registry.Num() != m_eventDefinitions->GetRowMap().Num());
+}
+
+void UGameEventManager::WatchTable()
+{
+	m_isRegistryStale = false;
+	if (m_watchedTable.Get() == m_eventDefinitions)
+		return;
+
+	if (UDataTable* watched = m_watchedTable.Get())
+		watched->OnDataTableChanged().Remove(m_tableEditedHandle);
+	m_tableEditedHandle.Reset();
+
+	m_watchedTable = m_eventDefinitions;
+	if (m_eventDefinitions)
+		m_tableEditedHandle = m_eventDefinitions->OnDataTableChanged().AddUObject(this, &UGameEventManager::MarkRegistryStale);
+}
+
+void UGameEventManager::PostEditChangeProperty(FPropertyChangedEvent& propertyChangedEvent)
+{
+	Super::PostEditChangeProperty(propertyChangedEvent);
+
+	if (propertyChangedEvent.GetPropertyName() == GET_MEMBER_NAME_CHECKED(UGameEventManager, m_eventDefinitions))
+		BuildRegistry();
+}
+#endif
+
+void UGameEventManager::Clear()
+{
+#if WITH_EDITOR
+	if (m_eventDefinitions && m_tableChangedHandle.IsValid())
+		m_eventDefinitions->OnDataTableChanged().Remove(m_tableChangedHandle);
+	m_tableChangedHandle.Reset();
+#endif
+
+	// Waiting coroutines are resumed before anything is torn down, they might still use the manager.
+	// Indexed, as they can instantiate lazy events.
+	for (int32 i = 0; i < m_events.Num(); i++)
+	{
+		if (m_events[i] != nullptr)
+			m_events[i]->CancelWaiters();
+	}
+
+	// Somebody might still hold a reference to an event, don't leave it pointing into the mask.
+	for (UGameEvent* ev : m_events)
+	{
+		if (ev != nullptr)
+		{
+			UnlinkEnableBit(*ev);
+			ev->m_numSpatialListeners = 0;
+		}
+	}
+
+	m_events.Empty();
+	m_eventHash.Reset();
+	m_eventTrie.Reset();
+	m_wildcardListeners.Empty();
+	m_spatialListeners.Empty();
+	m_spatialGrid.Empty();
+	m_freeSpatialListener = INDEX_NONE;
+	m_pendingFreeSpatialListeners.Empty();
+	m_pendingLodDeliveries.Empty();
+	m_deferred.Empty();
+	m_freeDeferred = INDEX_NONE;
+	for (int32 queue = 0; queue < NumDeferredQueues; queue++)
+	{
+		m_deferredQueues[queue].Empty();
+		m_deferredHeads[queue] = 0;
+	}
+	m_enabledMask.Empty();
+	ClearTimers();
+}
+
+UGameEventDynamic* UGameEventManager::GetDynamic(FName id, bool& success)
+{
+	return CastDynamic(FindOrInstantiate(id), success);
+}
+
+UGameEvent& UGameEventManager::Get(const FName& id)
+{
+	UGameEvent* ev = FindOrInstantiate(id);
+	check(ev != nullptr);
+	return *ev;
+}
+
+FGameEventHandle UGameEventManager::ResolveEvent(FName id, bool& success)
+{
+	FGameEventHandle handle;
+	handle.m_name = id;
+	handle.m_index = m_eventHash.Find(id);
+	success = handle.IsValid();
+	return handle;
+}
+
+UGameEventDynamic* UGameEventManager::GetDynamicByHandle(FGameEventHandle& handle, bool& success)
+{
+	return CastDynamic(FindOrInstantiate(handle), success);
+}
+
+UGameEvent& UGameEventManager::Get(FGameEventHandle& handle)
+{
+	UGameEvent* ev = FindOrInstantiate(handle);
+	check(ev != nullptr);
+	return *ev;
+}
+
+FGameEventHandle UGameEventManager::MakeHandle(const FName& id) const
+{
+	FGameEventHandle handle;
+	handle.m_name = id;
+	handle.m_index = m_eventHash.Find(id);
+	return handle;
+}
+
+int32 UGameEventManager::AllocateTimer(const FGameEventHandle& handle, uint64 signatureHash, double delay, double period)
+{
+	int32 index = m_freeTimer;
+	if (index == INDEX_NONE)
+		index = m_timers.AddDefaulted();
+	else
+		m_freeTimer = m_timers[index].m_next;
+
+	FGameEventTimer& timer = m_timers[index];
+	timer.m_serial = m_nextTimerSerial++;
+	timer.m_event = handle;
+	timer.m_signatureHash = signatureHash;
+	timer.m_args.Reset();
+	timer.m_deadline = m_timerTime + FMath::Max(delay, 0.0);
+	timer.m_period = period;
+
+	LinkTimer(index, false);
+	m_numScheduledTimers++;
+	return index;
+}
+
+void UGameEventManager::FreeTimer(int32 index)
+{
+	UnlinkTimer(index);
+
+	// Handles to this slot stay invalid, the next timer in it gets a new serial. Stale objects aren't kept around in the pool.
+	FGameEventTimer& timer = m_timers[index];
+	timer.m_serial = 0;
+	timer.m_args.Reset();
+	timer.m_next = m_freeTimer;
+	m_freeTimer = index;
+	m_numScheduledTimers--;
+}
+
+void UGameEventManager::LinkTimer(int32 index, bool allowCurrentTick)
+{
+	FGameEventTimer& timer = m_timers[index];
+
+	// The current tick has been processed already. New timers are due in the next one at the earliest,
+	// cascading and periodic timers that are due right away go to the list that is being fired.
+	const uint64 deadlineTick = static_cast<uint64>(FMath::CeilToDouble(timer.m_deadline * TimerTicksPerSecond));
+	const uint64 tick = FMath::Max(deadlineTick, m_timerTick + (allowCurrentTick ? 0 : 1));
+	const uint64 delta = tick - m_timerTick;
+
+	int32 slot = INDEX_NONE;
+	if (delta == 0)
+	{
+		slot = TimerDueSlot;
+	}
+	else
+	{
+		int32 level = 0;
+		while (level < TimerWheelLevels - 1 && delta >= (uint64(1) << (TimerWheelBits * (level + 1))))
+			level++;
+
+		// Beyond the range of the wheel, park it in the slot of the last level that cascades last.
+		const uint64 levelTick = delta >> (TimerWheelBits * (level + 1)) != 0 ? (m_timerTick >> (TimerWheelBits * level)) + TimerWheelSlots - 1 : tick >> (TimerWheelBits * level);
+		slot = level * TimerWheelSlots + static_cast<int32>(levelTick & (TimerWheelSlots - 1));
+	}
+
+	timer.m_slot = slot;
+	timer.m_prev = INDEX_NONE;
+	timer.m_next = m_timerSlots[slot];
+	if (timer.m_next != INDEX_NONE)
+		m_timers[timer.m_next].m_prev = index;
+	m_timerSlots[slot] = index;
+}
+
+void UGameEventManager::UnlinkTimer(int32 index)
+{
+	FGameEventTimer& timer = m_timers[index];
+	if (timer.m_slot == INDEX_NONE)
+		return;
+
+	if (timer.m_prev != INDEX_NONE)
+		m_timers[timer.m_prev].m_next = timer.m_next;
+	else
+		m_timerSlots[timer.m_slot] = timer.m_next;
+
+	if (timer.m_next != INDEX_NONE)
+		m_timers[timer.m_next].m_prev = timer.m_prev;
+
+	timer.m_slot = INDEX_NONE;
+	timer.m_prev = INDEX_NONE;
+	timer.m_next = INDEX_NONE;
+}
+
+bool UGameEventManager::CancelBroadcast(FGameEventTimerHandle& timer)
+{
+	const bool scheduled = IsBroadcastScheduled(timer);
+	if (scheduled)
+		FreeTimer(timer.m_index);
+
+	timer.Invalidate();
+	return scheduled;
+}
+
+bool UGameEventManager::IsBroadcastScheduled(const FGameEventTimerHandle& timer) const
+{
+	return m_timers.IsValidIndex(timer.m_index) && m_timers[timer.m_index].m_serial == timer.m_serial && m_timers[timer.m_index].m_slot != INDEX_NONE;
+}
+
+void UGameEventManager::AdvanceTimers(float deltaTime)
+{
+	// A listener advancing time from inside a scheduled broadcast would fire timers out of order.
+	if (m_isAdvancingTimers)
+		return;
+
+	m_timerTime += deltaTime;
+	const uint64 targetTick = static_cast<uint64>(FMath::FloorToDouble(m_timerTime * TimerTicksPerSecond));
+
+	m_isAdvancingTimers = true;
+
+	while (m_timerTick < targetTick && m_numScheduledTimers > 0)
+	{
+		m_timerTick++;
+
+		// Whenever a level wraps around, the next slot of the level above is spread over the levels below.
+		for (int32 level = 1; level < TimerWheelLevels; level++)
+		{
+			if ((m_timerTick & ((uint64(1) << (TimerWheelBits * level)) - 1)) != 0)
+				break;
+
+			CascadeTimers(level);
+		}
+
+		// Move this tick's slot into the due list. Broadcasts scheduled by its listeners land in the next tick at the earliest.
+		const int32 slot = static_cast<int32>(m_timerTick & (TimerWheelSlots - 1));
+		while (m_timerSlots[slot] != INDEX_NONE)
+		{
+			const int32 index = m_timerSlots[slot];
+			UnlinkTimer(index);
+			FGameEventTimer& timer = m_timers[index];
+			timer.m_slot = TimerDueSlot;
+			timer.m_next = m_timerSlots[TimerDueSlot];
+			if (timer.m_next != INDEX_NONE)
+				m_timers[timer.m_next].m_prev = index;
+			m_timerSlots[TimerDueSlot] = index;
+		}
+
+		while (m_timerSlots[TimerDueSlot] != INDEX_NONE)
+			FireTimer(m_timerSlots[TimerDueSlot]);
+	}
+
+	// Nothing scheduled, jump straight to the current time.
+	if (m_numScheduledTimers == 0)
+		m_timerTick = targetTick;
+
+	m_isAdvancingTimers = false;
+}
+
+void UGameEventManager::CascadeTimers(int32 level)
+{
+	const int32 slot = level * TimerWheelSlots + static_cast<int32>((m_timerTick >> (TimerWheelBits * level)) & (TimerWheelSlots - 1));
+
+	int32 index = m_timerSlots[slot];
+	m_timerSlots[slot] = INDEX_NONE;
+
+	while (index != INDEX_NONE)
+	{
+		const int32 next = m_timers[index].m_next;
+		m_timers[index].m_slot = INDEX_NONE;
+		LinkTimer(index, true);
+		index = next;
+	}
+}
+
+void UGameEventManager::FireTimer(int32 index)
+{
+	UnlinkTimer(index);
+
+	UGameEvent* ev = ResolvePayloadEvent(m_timers[index].m_event, m_timers[index].m_signatureHash, TEXT("Scheduled"));
+	if (ev == nullptr)
+	{
+		FreeTimer(index);
+		return;
+	}
+
+	FGameEventTimer& timer = m_timers[index];
+	const bool periodic = timer.m_period > 0.0;
+	const bool broadcast = ev->IsEnabled() && ev->NeedsValues();
+
+	if (broadcast)
+	{
+		// One-shot timers hand their arguments over, periodic ones keep them for the next time.
+		for (int32 i = 0; i < timer.m_args.Num(); i++)
+		{
+			if (periodic)
+				ev->m_eventArgs[i].m_type = timer.m_args[i];
+			else
+				ev->m_eventArgs[i].m_type = MoveTemp(timer.m_args[i]);
+		}
+	}
+
+	// Reschedule or release before broadcasting, so listeners see the timer's real state and may cancel it.
+	if (periodic)
+	{
+		timer.m_deadline += timer.m_period;
+		LinkTimer(index, true);
+	}
+	else
+	{
+		FreeTimer(index);
+	}
+
+	if (broadcast)
+		ev->BroadcastDelegate();
+}
+
+UGameEvent* UGameEventManager::ResolvePayloadEvent(FGameEventHandle& handle, uint64 signatureHash, const TCHAR* context)
+{
+	// The handle is updated in place, in case a reload moved the event.
+	UGameEvent* ev = FindOrInstantiate(handle);
+	if (ev == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("%s broadcast of '%s' dropped, the event was removed from the table."), context, *handle.m_name.ToString());
+		return nullptr;
+	}
+
+	if (ev->m_signatureHash != signatureHash)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s broadcast of '%s' dropped, the arguments of the event changed since it was queued."), context, *ev->m_name.ToString());
+		return nullptr;
+	}
+
+	return ev;
+}
+
+int32 UGameEventManager::AllocateDeferred(const FGameEventHandle& handle, uint64 signatureHash, EGameEventPriority priority)
+{
+	int32 index = m_freeDeferred;
+	if (index == INDEX_NONE)
+		index = m_deferred.AddDefaulted();
+	else
+		m_freeDeferred = m_deferred[index].m_nextFree;
+
+	FGameEventDeferredBroadcast& deferred = m_deferred[index];
+	deferred.m_event = handle;
+	deferred.m_signatureHash = signatureHash;
+	deferred.m_args.Reset();
+	deferred.m_nextFree = INDEX_NONE;
+
+	// Critical events never get here, Normal and Low map to the two queues.
+	m_deferredQueues[static_cast<int32>(priority) - 1].Add(index);
+
+	m_deferredStats.m_queued++;
+	m_deferredStats.m_maxQueueLength = FMath::Max(m_deferredStats.m_maxQueueLength, GetNumDeferred());
+	return index;
+}
+
+int32 UGameEventManager::GetNumDeferred() const
+{
+	int32 num = 0;
+	for (int32 i = 0; i < NumDeferredQueues; i++)
+		num += m_deferredQueues[i].Num() - m_deferredHeads[i];
+	return num;
+}
+
+void UGameEventManager::DispatchDeferred(int32 index)
+{
+	UGameEvent* ev = ResolvePayloadEvent(m_deferred[index].m_event, m_deferred[index].m_signatureHash, TEXT("Deferred"));
+	const bool broadcast = ev != nullptr && ev->IsEnabled() && ev->NeedsValues();
+
+	if (broadcast)
+	{
+		FGameEventDeferredBroadcast& deferred = m_deferred[index];
+		for (int32 i = 0; i < deferred.m_args.Num(); i++)
+			ev->m_eventArgs[i].m_type = MoveTemp(deferred.m_args[i]);
+	}
+
+	// Release before broadcasting, listeners may queue new broadcasts. Stale objects aren't kept around in the pool.
+	m_deferred[index].m_args.Reset();
+	m_deferred[index].m_nextFree = m_freeDeferred;
+	m_freeDeferred = index;
+
+	if (broadcast)
+		ev->BroadcastDelegate();
+
+	m_deferredStats.m_dispatched++;
+}
+
+void UGameEventManager::ProcessDeferred()
+{
+	const double start = FPlatformTime::Seconds();
+	const double budget = m_deferredBudgetMs / 1000.0;
+	bool dispatchedAny = false;
+	bool outOfBudget = false;
+
+	// Normal before Low. Broadcasts queued by listeners join the back of their queue, and are dispatched this frame if the budget allows.
+	for (int32 queue = 0; queue < NumDeferredQueues && !outOfBudget; queue++)
+	{
+		while (m_deferredHeads[queue] < m_deferredQueues[queue].Num())
+		{
+			if (dispatchedAny && FPlatformTime::Seconds() - start >= budget)
+			{
+				outOfBudget = true;
+				break;
+			}
+
+			DispatchDeferred(m_deferredQueues[queue][m_deferredHeads[queue]++]);
+			dispatchedAny = true;
+		}
+	}
+
+	// Drop the consumed part of the queues, the remainder carries over to the next frame.
+	for (int32 queue = 0; queue < NumDeferredQueues; queue++)
+	{
+		m_deferredQueues[queue].RemoveAt(0, m_deferredHeads[queue], false);
+		m_deferredHeads[queue] = 0;
+	}
+
+	if (outOfBudget)
+	{
+		m_deferredStats.m_framesOverBudget++;
+		m_deferredStats.m_carriedOver += GetNumDeferred();
+	}
+
+	const float overrunMs = static_cast<float>((FPlatformTime::Seconds() - start - budget) * 1000.0);
+	if (overrunMs > 0.0f)
+	{
+		m_deferredStats.m_overruns++;
+		m_deferredStats.m_maxOverrunMs = FMath::Max(m_deferredStats.m_maxOverrunMs, overrunMs);
+	}
+}
+
+void UGameEventManager::ClearTimers()
+{
+	m_timers.Empty();
+	for (int32& slot : m_timerSlots)
+		slot = INDEX_NONE;
+	m_freeTimer = INDEX_NONE;
+	m_numScheduledTimers = 0;
+	m_timerTime = 0.0;
+	m_timerTick = 0;
+}
+
+void UGameEventManager::AddReferencedObjects(UObject* inThis, FReferenceCollector& collector)
+{
+	Super::AddReferencedObjects(inThis, collector);
+
+	UGameEventManager* manager = CastChecked<UGameEventManager>(inThis);
+
+	// Only scheduled timers, free ones hold no arguments.
+	for (FGameEventTimer& timer : manager->m_timers)
+	{
+		if (timer.m_slot != INDEX_NONE)
+			AddReferencedArgs(collector, timer.m_args);
+	}
+
+	// Broadcasts held back by the LOD wait for a later frame.
+	for (FGameEventSpatialListener& spatial : manager->m_spatialListeners)
+	{
+		if (spatial.m_event == nullptr || spatial.m_pendingCount == 0)
+			continue;
+
+		for (CEventArg& arg : spatial.m_pendingArgs)
+			AddReferencedArg(collector, arg.m_type);
+	}
+
+	// Deferred broadcasts can wait several frames when the budget runs out.
+	for (int32 queue = 0; queue < NumDeferredQueues; queue++)
+	{
+		for (int32 i = manager->m_deferredHeads[queue]; i < manager->m_deferredQueues[queue].Num(); i++)
+			AddReferencedArgs(collector, manager->m_deferred[manager->m_deferredQueues[queue][i]].m_args);
+	}
+}
+
+void UGameEventManager::Tick(float deltaTime)
+{
+	AdvanceTimers(deltaTime);
+
+	if (m_pendingLodDeliveries.Num() > 0)
+		FlushLodDeliveries();
+
+	if (GetNumDeferred() > 0)
+		ProcessDeferred();
+}
+
+bool UGameEventManager::IsTickable() const
+{
+	return m_numScheduledTimers > 0 || m_pendingLodDeliveries.Num() > 0 || GetNumDeferred() > 0;
+}
+
+ETickableTickType UGameEventManager::GetTickableTickType() const
+{
+	return HasAnyFlags(RF_ClassDefaultObject) ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
+
+TStatId UGameEventManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGameEventManager, STATGROUP_Tickables);
+}
+
+FDelegateHandle UGameEventManager::AddWildcardListener(const FString& pattern, FGameEventDelegate::FDelegate&& listener)
+{
+	FGameEventListener entry;
+	entry.m_native = MoveTemp(listener);
+	return AddWildcard(pattern, MoveTemp(entry));
+}
+
+void UGameEventManager::ListenWildcard(const FString& pattern, const FGameEventListenerDynamic& listener)
+{
+	FGameEventListener entry;
+	if (UGameEvent::MakeBlueprintListener(listener, pattern, entry))
+		AddWildcard(pattern, MoveTemp(entry));
+}
+
+FDelegateHandle UGameEventManager::AddWildcard(const FString& pattern, FGameEventListener&& listener)
+{
+	TArray<int32> indices;
+	if (!m_eventTrie.Match(pattern, indices))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Wildcard pattern '%s' is malformed, only a trailing '*' segment is supported, e.g. 'Combat.Damage.*'."), *pattern);
+		return FDelegateHandle();
+	}
+
+	listener.m_handle = FDelegateHandle(FDelegateHandle::GenerateNewHandle);
+
+	FGameEventWildcardListener& wildcard = m_wildcardListeners.AddDefaulted_GetRef();
+	wildcard.m_pattern = pattern;
+	wildcard.m_listener = MoveTemp(listener);
+
+	// Copy the listener into every matching event up front, dispatch then never looks at the pattern again.
+	// Lazy events have to be created for this.
+	const FGameEventListener prototype = wildcard.m_listener;
+	for (const int32 index : indices)
+		FindOrInstantiate(index)->InsertListener(FGameEventListener(prototype), true);
+
+	return prototype.m_handle;
+}
+
+void UGameEventManager::RemoveWildcardListener(FDelegateHandle handle)
+{
+	const int32 found = m_wildcardListeners.IndexOfByPredicate([&handle](const FGameEventWildcardListener& wildcard) { return wildcard.m_listener.m_handle == handle; });
+	if (found == INDEX_NONE)
+		return;
+
+	TArray<int32> indices;
+	m_eventTrie.Match(m_wildcardListeners[found].m_pattern, indices);
+	m_wildcardListeners.RemoveAt(found);
+
+	for (const int32 index : indices)
+	{
+		if (m_events[index] != nullptr)
+			m_events[index]->RemoveListener(handle);
+	}
+}
+
+void UGameEventManager::StopListeningWildcard(const FString& pattern, const FGameEventListenerDynamic& listener)
+{
+	const UObject* object = listener.GetUObject();
+	const FName functionName = listener.GetFunctionName();
+
+	const FGameEventWildcardListener* found = m_wildcardListeners.FindByPredicate([&pattern, object, &functionName](const FGameEventWildcardListener& wildcard)
+	{
+		const FGameEventListener& entry = wildcard.m_listener;
+		return wildcard.m_pattern == pattern && entry.m_function != nullptr && entry.m_object.Get() == object && entry.m_function->GetFName() == functionName;
+	});
+
+	if (found != nullptr)
+		RemoveWildcardListener(found->m_listener.m_handle);
+}
+
+void UGameEventManager::ApplyWildcardListeners()
+{
+	TArray<int32> indices;
+	for (int32 i = 0; i < m_wildcardListeners.Num(); i++)
+	{
+		indices.Reset();
+		m_eventTrie.Match(m_wildcardListeners[i].m_pattern, indices);
+
+		for (const int32 index : indices)
+		{
+			UGameEvent* ev = FindOrInstantiate(index);
+			const FGameEventListener& listener = m_wildcardListeners[i].m_listener;
+			if (!ev->HasListener(listener.m_handle))
+				ev->InsertListener(FGameEventListener(listener), false);
+		}
+	}
+}
+
+FGameEventSpatialHandle UGameEventManager::AddSpatialListener(FGameEventHandle& handle, const FVector& position, float radius, FGameEventDelegate::FDelegate&& listener, bool useLod)
+{
+	FGameEventListener entry;
+	entry.m_native = MoveTemp(listener);
+	return AddSpatial(handle, position, radius, MoveTemp(entry), useLod);
+}
+
+FGameEventSpatialHandle UGameEventManager::ListenNearby(FGameEventHandle& handle, FVector position, float radius, const FGameEventListenerDynamic& listener, bool useLod)
+{
+	FGameEventListener entry;
+	if (!UGameEvent::MakeBlueprintListener(listener, handle.m_name.ToString(), entry))
+		return FGameEventSpatialHandle();
+
+	return AddSpatial(handle, position, radius, MoveTemp(entry), useLod);
+}
+
+void UGameEventManager::SetSpatialListenerSignificance(const FGameEventSpatialHandle& spatialHandle, float significance)
+{
+	if (IsSpatialHandleValid(spatialHandle))
+		m_spatialListeners[spatialHandle.m_index].m_significance = FMath::Max(significance, KINDA_SMALL_NUMBER);
+}
+
+FGameEventSpatialHandle UGameEventManager::AddSpatial(FGameEventHandle& handle, const FVector& position, float radius, FGameEventListener&& listener, bool useLod)
+{
+	UGameEvent* ev = FindOrInstantiate(handle);
+	if (ev == nullptr || ev->m_locationArgIndex == INDEX_NONE)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Can't add a spatial listener to event '%s', it doesn't exist or has no location argument."), *handle.m_name.ToString());
+		return FGameEventSpatialHandle();
+	}
+
+	int32 index = m_freeSpatialListener;
+	if (index == INDEX_NONE)
+		index = m_spatialListeners.AddDefaulted();
+	else
+		m_freeSpatialListener = m_spatialListeners[index].m_nextFree;
+
+	FGameEventSpatialListener& spatial = m_spatialListeners[index];
+	spatial.m_listener = MoveTemp(listener);
+	spatial.m_listener.m_handle = FDelegateHandle(FDelegateHandle::GenerateNewHandle);
+	spatial.m_event = ev;
+	spatial.m_position = position;
+	spatial.m_radius = FMath::Max(radius, 0.0f);
+	spatial.m_useLod = useLod;
+	spatial.m_significance = 1.0f;
+	spatial.m_lastDeliveryFrame = 0;
+	spatial.m_nextFree = INDEX_NONE;
+	LinkSpatialListener(index);
+	ev->m_numSpatialListeners++;
+
+	FGameEventSpatialHandle spatialHandle;
+	spatialHandle.m_index = index;
+	spatialHandle.m_serial = spatial.m_serial;
+	return spatialHandle;
+}
+
+void UGameEventManager::MoveSpatialListener(const FGameEventSpatialHandle& spatialHandle, FVector position)
+{
+	if (!IsSpatialHandleValid(spatialHandle))
+		return;
+
+	FGameEventSpatialListener& spatial = m_spatialListeners[spatialHandle.m_index];
+	const FVector extent(spatial.m_radius);
+	const FIntVector minCell = GetSpatialCell(position - extent);
+	const FIntVector maxCell = GetSpatialCell(position + extent);
+
+	// Most moves stay within the same cells, only the position changes then. Oversized listeners stay put as long as they are still oversized.
+	const bool isOversized = spatial.m_minCell == OversizedSpatialCell;
+	if (isOversized ? IsSpatialRangeOversized(minCell, maxCell) : (minCell == spatial.m_minCell && maxCell == spatial.m_maxCell))
+	{
+		spatial.m_position = position;
+		return;
+	}
+
+	UnlinkSpatialListener(spatialHandle.m_index);
+	spatial.m_position = position;
+	LinkSpatialListener(spatialHandle.m_index);
+}
+
+void UGameEventManager::RemoveSpatialListener(FGameEventSpatialHandle& spatialHandle)
+{
+	if (IsSpatialHandleValid(spatialHandle))
+		FreeSpatialListener(spatialHandle.m_index);
+
+	spatialHandle = FGameEventSpatialHandle();
+}
+
+bool UGameEventManager::IsSpatialHandleValid(const FGameEventSpatialHandle& spatialHandle) const
+{
+	return m_spatialListeners.IsValidIndex(spatialHandle.m_index) && m_spatialListeners[spatialHandle.m_index].m_serial == spatialHandle.m_serial && m_spatialListeners[spatialHandle.m_index].m_event != nullptr;
+}
+
+FIntVector UGameEventManager::GetSpatialCell(const FVector& position) const
+{
+	// Floored, converting to FIntVector directly would round negative coordinates towards zero.
+	return FIntVector(FMath::FloorToInt(position.X / m_spatialCellSize), FMath::FloorToInt(position.Y / m_spatialCellSize), FMath::FloorToInt(position.Z / m_spatialCellSize));
+}
+
+bool UGameEventManager::IsSpatialRangeOversized(const FIntVector& minCell, const FIntVector& maxCell)
+{
+	const FIntVector size = maxCell - minCell + FIntVector(1, 1, 1);
+	return static_cast<int64>(size.X) * size.Y * size.Z > MaxSpatialCellsPerListener;
+}
+
+void UGameEventManager::LinkSpatialListener(int32 index)
+{
+	FGameEventSpatialListener& spatial = m_spatialListeners[index];
+	const FVector extent(spatial.m_radius);
+	spatial.m_minCell = GetSpatialCell(spatial.m_position - extent);
+	spatial.m_maxCell = GetSpatialCell(spatial.m_position + extent);
+
+	// A listener goes into every cell its sphere overlaps, so a broadcast only has to look at the single cell it happens in.
+	if (IsSpatialRangeOversized(spatial.m_minCell, spatial.m_maxCell))
+	{
+		spatial.m_minCell = spatial.m_maxCell = OversizedSpatialCell;
+		m_spatialGrid.FindOrAdd({ spatial.m_event, OversizedSpatialCell }).Add(index);
+		return;
+	}
+
+	for (int32 x = spatial.m_minCell.X; x <= spatial.m_maxCell.X; x++)
+	{
+		for (int32 y = spatial.m_minCell.Y; y <= spatial.m_maxCell.Y; y++)
+		{
+			for (int32 z = spatial.m_minCell.Z; z <= spatial.m_maxCell.Z; z++)
+				m_spatialGrid.FindOrAdd({ spatial.m_event, FIntVector(x, y, z) }).Add(index);
+		}
+	}
+}
+
+void UGameEventManager::UnlinkSpatialListener(int32 index)
+{
+	const FGameEventSpatialListener& spatial = m_spatialListeners[index];
+
+	// The oversized cell sits at MAX_int32 on every axis, walking the range up to it would overflow.
+	if (spatial.m_minCell == OversizedSpatialCell)
+	{
+		RemoveFromSpatialCell({ spatial.m_event, OversizedSpatialCell }, index);
+		return;
+	}
+
+	for (int32 x = spatial.m_minCell.X; x <= spatial.m_maxCell.X; x++)
+	{
+		for (int32 y = spatial.m_minCell.Y; y <= spatial.m_maxCell.Y; y++)
+		{
+			for (int32 z = spatial.m_minCell.Z; z <= spatial.m_maxCell.Z; z++)
+				RemoveFromSpatialCell({ spatial.m_event, FIntVector(x, y, z) }, index);
+		}
+	}
+}
+
+void UGameEventManager::RemoveFromSpatialCell(const FGameEventSpatialCell& key, int32 index)
+{
+	TArray<int32>* cell = m_spatialGrid.Find(key);
+	if (cell == nullptr)
+		return;
+
+	cell->RemoveSingleSwap(index, false);
+	if (cell->Num() == 0)
+		m_spatialGrid.Remove(key);
+}
+
+void UGameEventManager::FreeSpatialListener(int32 index)
+{
+	UnlinkSpatialListener(index);
+
+	// Bumping the serial invalidates every handle to this slot.
+	FGameEventSpatialListener& spatial = m_spatialListeners[index];
+	spatial.m_event->m_numSpatialListeners--;
+	spatial.m_event = nullptr;
+	spatial.m_pendingArgs.Reset();
+	spatial.m_pendingCount = 0;
+	spatial.m_serial++;
+
+	// The slot might still be among the candidates of a running dispatch, don't hand it out before that's done.
+	// The delegate might be the one running, e.g. a lambda removing itself. Destroying it now would free its captures mid-call.
+	if (m_spatialDispatchDepth > 0)
+	{
+		m_pendingFreeSpatialListeners.Add(index);
+		return;
+	}
+
+	spatial.m_listener = FGameEventListener();
+	spatial.m_nextFree = m_freeSpatialListener;
+	m_freeSpatialListener = index;
+}
+
+void UGameEventManager::DispatchSpatial(UGameEvent& ev, const FVector& location)
+{
+	// Copy the candidates, listeners may add or remove spatial listeners which reshapes the grid.
+	TArray<int32, TInlineAllocator<64>> candidates;
+	if (const TArray<int32>* cell = m_spatialGrid.Find({ &ev, GetSpatialCell(location) }))
+		candidates.Append(*cell);
+	if (const TArray<int32>* oversized = m_spatialGrid.Find({ &ev, OversizedSpatialCell }))
+		candidates.Append(*oversized);
+
+	if (candidates.Num() == 0)
+		return;
+
+	m_spatialDispatchDepth++;
+
+	const bool useLod = m_lodTiers.Num() > 0;
+
+	for (const int32 index : candidates)
+	{
+		FGameEventSpatialListener& spatial = m_spatialListeners[index];
+
+		// Removed by an earlier listener of this dispatch.
+		if (spatial.m_event != &ev)
+			continue;
+
+		const float distanceSquared = FVector::DistSquared(spatial.m_position, location);
+		if (distanceSquared > FMath::Square(spatial.m_radius))
+			continue;
+
+		if (useLod && spatial.m_useLod)
+		{
+			// Full rate listeners are never held back, even when they were called earlier in the same frame.
+			const int32 interval = GetLodFrameInterval(FMath::Sqrt(distanceSquared) / spatial.m_significance);
+			const uint64 dueFrame = spatial.m_lastDeliveryFrame + interval;
+			if (interval > 1 && GFrameCounter < dueFrame)
+			{
+				// Hold back the latest arguments only, the copy reuses the buffers of the previous one.
+				// Saved calls are counted once the held back broadcasts are delivered or superseded.
+				if (spatial.m_pendingCount == 0)
+					m_pendingLodDeliveries.Emplace(index, spatial.m_serial);
+
+				spatial.m_pendingArgs = ev.m_eventArgs;
+				spatial.m_pendingSignatureHash = ev.m_signatureHash;
+				spatial.m_pendingDueFrame = dueFrame;
+				spatial.m_pendingCount++;
+				m_lodStats.m_coalesced++;
+				continue;
+			}
+
+			// A held back broadcast is superseded by this one.
+			m_lodStats.m_saved += spatial.m_pendingCount;
+			spatial.m_pendingCount = 0;
+			spatial.m_lastDeliveryFrame = GFrameCounter;
+		}
+
+		m_lodStats.m_delivered++;
+		if (!InvokeSpatialListener(spatial, ev))
+			FreeSpatialListener(index);
+	}
+
+	m_spatialDispatchDepth--;
+
+	if (m_spatialDispatchDepth == 0)
+		ReleasePendingSpatialListeners();
+}
+
+bool UGameEventManager::InvokeSpatialListener(FGameEventSpatialListener& spatial, UGameEvent& ev)
+{
+	if (spatial.m_listener.m_native.IsBound())
+	{
+		spatial.m_listener.m_native.Execute(ev);
+		return true;
+	}
+
+	UObject* object = spatial.m_listener.m_object.Get();
+	if (object == nullptr)
+		return false;
+
+	struct FListenerParams
+	{
+		UGameEvent* EventData;
+	};
+	FListenerParams params = { &ev };
+	object->ProcessEvent(spatial.m_listener.m_function, &params);
+	return true;
+}
+
+int32 UGameEventManager::GetLodFrameInterval(float distance) const
+{
+	// Tiers are few and don't need to be sorted, the furthest one the distance reaches wins.
+	float tierDistance = -1.0f;
+	int32 interval = 1;
+	for (const FGameEventLodTier& tier : m_lodTiers)
+	{
+		if (distance >= tier.m_minDistance && tier.m_minDistance > tierDistance)
+		{
+			tierDistance = tier.m_minDistance;
+			interval = FMath::Max(tier.m_frameInterval, 1);
+		}
+	}
+
+	return interval;
+}
+
+void UGameEventManager::FlushLodDeliveries()
+{
+	// Listeners may broadcast again and coalesce new deliveries, those are picked up by the next flush.
+	TArray<TPair<int32, int32>> pending = MoveTemp(m_pendingLodDeliveries);
+	m_pendingLodDeliveries.Reset();
+
+	m_spatialDispatchDepth++;
+
+	for (const TPair<int32, int32>& delivery : pending)
+	{
+		FGameEventSpatialListener& spatial = m_spatialListeners[delivery.Key];
+
+		// Removed, or already superseded by a delivery at full rate.
+		if (spatial.m_serial != delivery.Value || spatial.m_pendingCount == 0)
+			continue;
+
+		if (GFrameCounter < spatial.m_pendingDueFrame)
+		{
+			m_pendingLodDeliveries.Add(delivery);
+			continue;
+		}
+
+		UGameEvent* ev = spatial.m_event;
+		const int32 count = spatial.m_pendingCount;
+		spatial.m_pendingCount = 0;
+		spatial.m_lastDeliveryFrame = GFrameCounter;
+
+		// A reload changed the arguments since, the held back ones can't be delivered anymore.
+		if (spatial.m_pendingSignatureHash != ev->m_signatureHash)
+		{
+			m_lodStats.m_saved += count;
+			continue;
+		}
+
+		m_lodStats.m_delivered++;
+		m_lodStats.m_saved += count - 1;
+
+		// Swap the held back arguments in for the call, and the event's own arguments back afterwards.
+		TArray<CEventArg> args = MoveTemp(spatial.m_pendingArgs);
+		Swap(ev->m_eventArgs, args);
+		ev->m_coalescedCount = count;
+
+		const bool alive = InvokeSpatialListener(m_spatialListeners[delivery.Key], *ev);
+
+		ev->m_coalescedCount = 1;
+		Swap(ev->m_eventArgs, args);
+
+		if (!alive)
+		{
+			FreeSpatialListener(delivery.Key);
+			continue;
+		}
+
+		// Hand the buffers back for the next coalesced broadcast, unless the call coalesced a new one already.
+		FGameEventSpatialListener& after = m_spatialListeners[delivery.Key];
+		if (after.m_serial == delivery.Value && after.m_pendingCount == 0)
+			after.m_pendingArgs = MoveTemp(args);
+	}
+
+	m_spatialDispatchDepth--;
+
+	if (m_spatialDispatchDepth == 0)
+		ReleasePendingSpatialListeners();
+}
+
+void UGameEventManager::ReleasePendingSpatialListeners()
+{
+	for (const int32 index : m_pendingFreeSpatialListeners)
+	{
+		m_spatialListeners[index].m_listener = FGameEventListener();
+		m_spatialListeners[index].m_nextFree = m_freeSpatialListener;
+		m_freeSpatialListener = index;
+	}
+	m_pendingFreeSpatialListeners.Reset();
+}
+
+void UGameEventManager::RebindSpatialListeners(UGameEvent* from, UGameEvent* to)
+{
+	if (from->m_numSpatialListeners == 0)
+		return;
+
+	for (int32 i = 0; i < m_spatialListeners.Num(); i++)
+	{
+		if (m_spatialListeners[i].m_event != from)
+			continue;
+
+		if (to == nullptr)
+		{
+			FreeSpatialListener(i);
+			continue;
+		}
+
+		UnlinkSpatialListener(i);
+		m_spatialListeners[i].m_event = to;
+		LinkSpatialListener(i);
+		from->m_numSpatialListeners--;
+		to->m_numSpatialListeners++;
+	}
+}
+
+bool UGameEventManager::ReadLatest(const FGameEventHandle& handle, TArray<uint8>& outPacked, const FGameEventPackedLayout** outLayout) const
+{
+	// No lazy instantiation and no handle fix-up here, nothing that writes. Events storing their latest value are created by Setup().
+	if (!m_events.IsValidIndex(handle.m_index) || m_registry[handle.m_index].m_name != handle.m_name)
+		return false;
+
+	const UGameEvent* ev = m_events[handle.m_index];
+	return ev != nullptr && ev->ReadLatest(outPacked, outLayout);
+}
+
+UGameEventDynamic* UGameEventManager::CastDynamic(UGameEvent* ev, bool& success) const
+{
+	if (ev == nullptr)
+	{
+		success = false;
+		return nullptr;
+	}
+
+	// The flag is cached on the event, no need for a full IsA() check.
+	if (!ev->m_isDynamic)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Event '%s' was requested as dynamic, but it isn't marked as dynamic in the table."), *ev->m_name.ToString());
+		success = false;
+		return nullptr;
+	}
+
+	success = true;
+	return static_cast<UGameEventDynamic*>(ev);
+}
+
+bool UGameEvent::SetValueFromProperty(int32 index, const FProperty* property, const void* address)
+{
+	if (property == nullptr || address == nullptr)
+		return false;
+
+	EventArgType& value = m_eventArgs[index].m_type;
+
+	if (value.IsType<int>())
+	{
+		const FIntProperty* prop = CastField<FIntProperty>(property);
+		if (prop != nullptr)
+			value.Get<int>() = prop->GetPropertyValue(address);
+		return prop != nullptr;
+	}
+	else if (value.IsType<float>())
+	{
+		const FFloatProperty* prop = CastField<FFloatProperty>(property);
+		if (prop != nullptr)
+			value.Get<float>() = prop->GetPropertyValue(address);
+		return prop != nullptr;
+	}
+	else if (value.IsType<bool>())
+	{
+		const FBoolProperty* prop = CastField<FBoolProperty>(property);
+		if (prop != nullptr)
+			value.Get<bool>() = prop->GetPropertyValue(address);
+		return prop != nullptr;
+	}
+	else if (value.IsType<FName>())
+	{
+		const FNameProperty* prop = CastField<FNameProperty>(property);
+		if (prop != nullptr)
+			value.Get<FName>() = prop->GetPropertyValue(address);
+		return prop != nullptr;
+	}
+	else if (value.IsType<FString>())
+	{
+		const FStrProperty* prop = CastField<FStrProperty>(property);
+		if (prop != nullptr)
+			AssignArg(value.Get<FString>(), prop->GetPropertyValue(address));
+		return prop != nullptr;
+	}
+	else if (value.IsType<FVector>() || value.IsType<FVector2D>() || value.IsType<FRotator>())
+	{
+		const FStructProperty* prop = CastField<FStructProperty>(property);
+		if (prop == nullptr)
+			return false;
+
+		if (value.IsType<FVector>() && prop->Struct == TBaseStructure<FVector>::Get())
+			value.Get<FVector>() = *static_cast<const FVector*>(address);
+		else if (value.IsType<FVector2D>() && prop->Struct == TBaseStructure<FVector2D>::Get())
+			value.Get<FVector2D>() = *static_cast<const FVector2D*>(address);
+		else if (value.IsType<FRotator>() && prop->Struct == TBaseStructure<FRotator>::Get())
+			value.Get<FRotator>() = *static_cast<const FRotator*>(address);
+		else
+			return false;
+
+		return true;
+	}
+	else if (value.IsType<UObject*>() || value.IsType<AActor*>())
+	{
+		const FObjectPropertyBase* prop = CastField<FObjectPropertyBase>(property);
+		if (prop == nullptr)
+			return false;
+
+		UObject* object = prop->GetObjectPropertyValue(address);
+		if (value.IsType<UObject*>())
+			value.Get<UObject*>() = object;
+		else
+			value.Get<AActor*>() = Cast<AActor>(object);
+
+		return true;
+	}
+	else if (value.IsType<uint8>())
+	{
+		// Blueprint enums are bytes, native enum classes come through as enum properties.
+		if (const FByteProperty* prop = CastField<FByteProperty>(property))
+		{
+			value.Get<uint8>() = prop->GetPropertyValue(address);
+			return true;
+		}
+
+		if (const FEnumProperty* prop = CastField<FEnumProperty>(property))
+		{
+			value.Get<uint8>() = static_cast<uint8>(prop->GetUnderlyingProperty()->GetUnsignedIntPropertyValue(address));
+			return true;
+		}
+
+		return false;
+	}
+
+	// Custom structs can't be sent from blueprints.
+	return false;
+}
+
+bool UGameEvent::AcceptsProperty(int32 index, const FProperty* property) const
+{
+	if (property == nullptr)
+		return false;
+
+	const EventArgType& value = m_eventArgs[index].m_type;
+
+	if (value.IsType<int>())
+		return property->IsA<FIntProperty>();
+	else if (value.IsType<float>())
+		return property->IsA<FFloatProperty>();
+	else if (value.IsType<bool>())
+		return property->IsA<FBoolProperty>();
+	else if (value.IsType<FName>())
+		return property->IsA<FNameProperty>();
+	else if (value.IsType<FString>())
+		return property->IsA<FStrProperty>();
+	else if (value.IsType<FVector>() || value.IsType<FVector2D>() || value.IsType<FRotator>())
+	{
+		const FStructProperty* prop = CastField<FStructProperty>(property);
+		if (prop == nullptr)
+			return false;
+
+		return (value.IsType<FVector>() && prop->Struct == TBaseStructure<FVector>::Get())
+			|| (value.IsType<FVector2D>() && prop->Struct == TBaseStructure<FVector2D>::Get())
+			|| (value.IsType<FRotator>() && prop->Struct == TBaseStructure<FRotator>::Get());
+	}
+	else if (value.IsType<UObject*>() || value.IsType<AActor*>())
+		return property->IsA<FObjectPropertyBase>();
+	else if (value.IsType<uint8>())
+		return property->IsA<FByteProperty>() || property->IsA<FEnumProperty>();
+
+	// Custom structs can't be sent from blueprints.
+	return false;
+}
+
+bool UGameEvent::GetValueToProperty(int32 index, const FProperty* property, void* address) const
+{
+	if (address == nullptr || !AcceptsProperty(index, property))
+		return false;
+
+	const EventArgType& value = m_eventArgs[index].m_type;
+
+	if (value.IsType<int>())
+		CastField<FIntProperty>(property)->SetPropertyValue(address, value.Get<int>());
+	else if (value.IsType<float>())
+		CastField<FFloatProperty>(property)->SetPropertyValue(address, value.Get<float>());
+	else if (value.IsType<bool>())
+		CastField<FBoolProperty>(property)->SetPropertyValue(address, value.Get<bool>());
+	else if (value.IsType<FName>())
+		CastField<FNameProperty>(property)->SetPropertyValue(address, value.Get<FName>());
+	else if (value.IsType<FString>())
+		CastField<FStrProperty>(property)->SetPropertyValue(address, value.Get<FString>());
+	else if (value.IsType<FVector>())
+		*static_cast<FVector*>(address) = value.Get<FVector>();
+	else if (value.IsType<FVector2D>())
+		*static_cast<FVector2D*>(address) = value.Get<FVector2D>();
+	else if (value.IsType<FRotator>())
+		*static_cast<FRotator*>(address) = value.Get<FRotator>();
+	else if (value.IsType<UObject*>())
+		CastField<FObjectPropertyBase>(property)->SetObjectPropertyValue(address, value.Get<UObject*>());
+	else if (value.IsType<AActor*>())
+		CastField<FObjectPropertyBase>(property)->SetObjectPropertyValue(address, value.Get<AActor*>());
+	else if (const FByteProperty* prop = CastField<FByteProperty>(property))
+		prop->SetPropertyValue(address, value.Get<uint8>());
+	else
+		CastField<FEnumProperty>(property)->GetUnderlyingProperty()->SetIntPropertyValue(address, static_cast<uint64>(value.Get<uint8>()));
+
+	return true;
+}
+
+void UGameEvent::GetValueAt(int32 index, FName id, int32& value) const
+{
+	// Only ever called through execGetValueAt, the output pin's type is only known inside the thunk.
+	check(0);
+}
+
+DEFINE_FUNCTION(UGameEvent::execGetValueAt)
+{
+	P_GET_PROPERTY(FIntProperty, index);
+	P_GET_PROPERTY(FNameProperty, id);
+
+	Stack.MostRecentProperty = nullptr;
+	Stack.MostRecentPropertyAddress = nullptr;
+	Stack.StepCompiledIn<FProperty>(nullptr);
+	const FProperty* property = Stack.MostRecentProperty;
+	void* address = Stack.MostRecentPropertyAddress;
+
+	P_FINISH;
+
+	P_NATIVE_BEGIN;
+	// The node baked the index in when the blueprint compiled, a mismatching name means the table changed since then.
+	// The output keeps its default value in that case.
+	const bool valid = P_THIS->m_eventArgs.IsValidIndex(index) && P_THIS->m_eventArgs[index].m_name == id;
+	if (!valid || !P_THIS->GetValueToProperty(index, property, address))
+		UE_LOG(LogTemp, Error, TEXT("Break of event '%s' from blueprint failed, recompile the blueprint. Argument '%s' doesn't match the table."), *P_THIS->m_name.ToString(), *id.ToString());
+	P_NATIVE_END;
+}
+
+bool UGameEvent::ParseArgValue(int32 index, const FString& text, EventArgType& value) const
+{
+	value = m_eventArgs[index].m_type;
+
+	if (value.IsType<int>())
+		value.Set<int>(FCString::Atoi(*text));
+	else if (value.IsType<float>())
+		value.Set<float>(FCString::Atof(*text));
+	else if (value.IsType<bool>())
+		value.Set<bool>(text.ToBool());
+	else if (value.IsType<FName>())
+		value.Set<FName>(FName(*text));
+	else if (value.IsType<FString>())
+		value.Set<FString>(text);
+	else if (value.IsType<uint8>())
+		value.Set<uint8>(static_cast<uint8>(FCString::Atoi(*text)));
+	else if (value.IsType<FVector>())
+		return value.Get<FVector>().InitFromString(text);
+	else if (value.IsType<FVector2D>())
+		return value.Get<FVector2D>().InitFromString(text);
+	else if (value.IsType<FRotator>())
+		return value.Get<FRotator>().InitFromString(text);
+	else
+		return false;
+
+	return true;
+}
+
+bool UGameEvent::ArgEquals(int32 index, const EventArgType& value) const
+{
+	const EventArgType& current = m_eventArgs[index].m_type;
+	if (current.GetIndex() != value.GetIndex())
+		return false;
+
+	if (current.IsType<int>())
+		return current.Get<int>() == value.Get<int>();
+	if (current.IsType<float>())
+		return FMath::IsNearlyEqual(current.Get<float>(), value.Get<float>());
+	if (current.IsType<bool>())
+		return current.Get<bool>() == value.Get<bool>();
+	if (current.IsType<FName>())
+		return current.Get<FName>() == value.Get<FName>();
+	if (current.IsType<FString>())
+		return current.Get<FString>() == value.Get<FString>();
+	if (current.IsType<uint8>())
+		return current.Get<uint8>() == value.Get<uint8>();
+	if (current.IsType<FVector>())
+		return current.Get<FVector>().Equals(value.Get<FVector>());
+	if (current.IsType<FVector2D>())
+		return current.Get<FVector2D>().Equals(value.Get<FVector2D>());
+	if (current.IsType<FRotator>())
+		return current.Get<FRotator>().Equals(value.Get<FRotator>());
+	if (current.IsType<UObject*>())
+		return current.Get<UObject*>() == value.Get<UObject*>();
+	if (current.IsType<AActor*>())
+		return current.Get<AActor*>() == value.Get<AActor*>();
+	if (current.IsType<FEventArgStruct*>())
+		return current.Get<FEventArgStruct*>() == value.Get<FEventArgStruct*>();
+
+	return false;
+}
+
+void UGameEvent::BuildArgLookups()
+{
+	const uint64 oldSignatureHash = m_signatureHash;
+
+	TArray<FName> names;
+	names.Reserve(m_eventArgs.Num());
+	m_signatureHash = GameEventSignatureHashBasis;
+
+	for (const CEventArg& arg : m_eventArgs)
+	{
+		names.Add(arg.m_name);
+		m_signatureHash = HashGameEventSignatureStep(m_signatureHash, arg.m_type.GetIndex());
+	}
+
+	m_argHash.Build(names);
+
+	// Only events storing their latest value or recording a history pack their arguments, the others never allocate a snapshot.
+	// Other threads might be reading the current snapshot, it's never rebuilt in place. Same signature means same layout, it's kept as is.
+	// Otherwise a new one is published. The latest value survives reloads, MigrateEvent() kept the arguments that still exist.
+	const FGameEventLatestSnapshot* current = m_snapshot.load(std::memory_order_relaxed);
+	const bool hadLatestValue = current != nullptr && current->m_value.HasValue();
+	if (!m_storesLatest && m_historySize == 0)
+	{
+		// A replaced snapshot stays in m_snapshots, readers might still be using it.
+		m_snapshot.store(nullptr, std::memory_order_release);
+	}
+	else if (current == nullptr || m_signatureHash != oldSignatureHash || (hadLatestValue && !m_storesLatest))
+	{
+		FGameEventLatestSnapshot& snapshot = *m_snapshots.Add_GetRef(MakeUnique<FGameEventLatestSnapshot>());
+		snapshot.m_layout.Build(m_eventArgs);
+		snapshot.m_value.Reset(snapshot.m_layout.GetSize());
+		if (m_storesLatest && hadLatestValue)
+			snapshot.m_value.Write(snapshot.m_layout, m_eventArgs);
+
+		m_snapshot.store(&snapshot, std::memory_order_release);
+	}
+
+	const FGameEventPackedLayout& layout = GetPackedLayout();
+
+	// Past records can't be re-packed, the history is only kept if the arguments didn't change.
+	if (m_historySize == 0)
+	{
+		m_history.Reset();
+	}
+	else if (!m_history.IsValid() || m_history->GetCapacity() != m_historySize || m_signatureHash != oldSignatureHash)
+	{
+		if (!m_history.IsValid())
+			m_history = MakeUnique<FGameEventHistory>();
+		m_history->Reset(m_historySize, layout.GetSize());
+	}
+
+	m_keepsValues = m_storesLatest || m_history.IsValid();
+
+	m_locationArgIndex = m_locationArgName.IsNone() ? INDEX_NONE : m_argHash.Find(m_locationArgName);
+	if (m_locationArgIndex != INDEX_NONE && !m_eventArgs[m_locationArgIndex].m_type.IsType<FVector>())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Location argument '%s' of event '%s' isn't an FVector, spatial listeners won't be called."), *m_locationArgName.ToString(), *m_name.ToString());
+		m_locationArgIndex = INDEX_NONE;
+	}
+	else if (m_locationArgIndex == INDEX_NONE && !m_locationArgName.IsNone())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Location argument '%s' of event '%s' doesn't exist, spatial listeners won't be called."), *m_locationArgName.ToString(), *m_name.ToString());
+	}
+}
+
+void UGameEvent::KeepValues()
+{
+	FGameEventLatestSnapshot& snapshot = *m_snapshot.load(std::memory_order_relaxed);
+
+	if (m_storesLatest)
+		snapshot.m_value.Write(snapshot.m_layout, m_eventArgs);
+
+	if (m_history.IsValid())
+		m_history->Record(snapshot.m_layout, m_eventArgs);
+}
+
+bool UGameEvent::ReadLatest(TArray<uint8>& outPacked, const FGameEventPackedLayout** outLayout) const
+{
+	// A single load, so the value and the layout always come from the same snapshot. Events not storing values never write it.
+	const FGameEventLatestSnapshot* snapshot = m_snapshot.load(std::memory_order_acquire);
+	if (snapshot == nullptr)
+		return false;
+
+	if (outLayout != nullptr)
+		*outLayout = &snapshot->m_layout;
+
+	outPacked.SetNumUninitialized(snapshot->m_layout.GetSize());
+	return snapshot->m_value.Read(outPacked.GetData());
+}
+
+void UGameEvent::ReportSignatureMismatch(const TCHAR* context, const SIZE_T* typeIndices, int32 num) const
+{
+	if (num != m_eventArgs.Num())
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s of event '%s' failed, got %d arguments but the table defines %d."), context, *m_name.ToString(), num, m_eventArgs.Num());
+		return;
+	}
+
+	for (int32 i = 0; i < num; i++)
+	{
+		if (m_eventArgs[i].m_type.GetIndex() != typeIndices[i])
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s mismatch found in event '%s' between the sent argument and '%s'"), context, *m_name.ToString(), *m_eventArgs[i].m_name.ToString());
+			return;
+		}
+	}
+
+	// Same types but a different hash would mean the compile time and runtime hashes went out of sync.
+	UE_LOG(LogTemp, Error, TEXT("%s of event '%s' failed, signature hash mismatch."), context, *m_name.ToString());
+}
+
+FDelegateHandle UGameEvent::AddListener(FGameEventDelegate::FDelegate&& listener, bool replayLatched)
+{
+	FGameEventListener entry;
+	entry.m_native = MoveTemp(listener);
+	entry.m_handle = FDelegateHandle(FDelegateHandle::GenerateNewHandle);
+
+	const FDelegateHandle handle = entry.m_handle;
+	InsertListener(MoveTemp(entry), replayLatched);
+	return handle;
+}
+
+void UGameEvent::RemoveListener(FDelegateHandle handle)
+{
+	const int32 index = m_listeners.IndexOfByPredicate([&handle](const FGameEventListener& listener) { return listener.m_handle == handle; });
+	if (index == INDEX_NONE)
+		return;
+
+	// Listeners may unbind themselves while being called, only unbind them then and compact the list after the dispatch.
+	if (m_dispatchDepth > 0)
+	{
+		MarkListenerRemoved(m_listeners[index]);
+		return;
+	}
+
+	m_listeners.RemoveAt(index);
+}
+
+void UGameEvent::Listen(const FGameEventListenerDynamic& listener)
+{
+	FGameEventListener entry;
+	if (!MakeBlueprintListener(listener, m_name.ToString(), entry))
+		return;
+
+	entry.m_handle = FDelegateHandle(FDelegateHandle::GenerateNewHandle);
+	InsertListener(MoveTemp(entry), true);
+}
+
+bool UGameEvent::MakeBlueprintListener(const FGameEventListenerDynamic& listener, const FString& target, FGameEventListener& outListener)
+{
+	UObject* object = listener.GetUObject();
+	UFunction* function = object != nullptr ? object->FindFunction(listener.GetFunctionName()) : nullptr;
+	if (function == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Can't listen to '%s', function '%s' could not be found."), *target, *listener.GetFunctionName().ToString());
+		return false;
+	}
+
+	outListener.m_object = object;
+	outListener.m_function = function;
+	return true;
+}
+
+void UGameEvent::InsertListener(FGameEventListener&& listener, bool replayLatched)
+{
+	// Keep Blueprint listeners of the same function next to each other, e.g. every instance of a blueprint class.
+	// During a dispatch we can only append, inserting would shift the listeners being iterated.
+	int32 insertAt = m_listeners.Num();
+	if (m_dispatchDepth == 0 && listener.m_function != nullptr)
+	{
+		UFunction* function = listener.m_function;
+		const int32 last = m_listeners.FindLastByPredicate([function](const FGameEventListener& entry) { return entry.m_function == function; });
+		if (last != INDEX_NONE)
+			insertAt = last + 1;
+	}
+
+	m_listeners.Insert(MoveTemp(listener), insertAt);
+
+	if (replayLatched)
+		ReplayLatched(insertAt);
+}
+
+void UGameEvent::StopListening(const FGameEventListenerDynamic& listener)
+{
+	const UObject* object = listener.GetUObject();
+	const FName functionName = listener.GetFunctionName();
+
+	const FGameEventListener* found = m_listeners.FindByPredicate([object, &functionName](const FGameEventListener& entry)
+	{
+		return entry.m_function != nullptr && entry.m_object.Get() == object && entry.m_function->GetFName() == functionName;
+	});
+
+	if (found != nullptr)
+		RemoveListener(found->m_handle);
+}
+
+void UGameEvent::BroadcastDelegate()
+{
+	if (m_keepsValues)
+		KeepValues();
+
+	m_dispatchDepth++;
+
+	// Parameter frame of FGameEventListenerDynamic, prepared once and shared by every Blueprint listener.
+	// ProcessEvent copies the parameters into its own frame, so the listeners can't modify it.
+	struct FListenerParams
+	{
+		UGameEvent* EventData;
+	};
+	FListenerParams params = { this };
+
+	// Listeners bound during the dispatch are only called from the next broadcast on.
+	const int32 num = m_listeners.Num();
+	for (int32 i = 0; i < num; i++)
+	{
+		FGameEventListener& listener = m_listeners[i];
+
+		if (listener.m_native.IsBound())
+		{
+			listener.m_native.Execute(*this);
+			continue;
+		}
+
+		if (listener.m_function == nullptr)
+			continue;
+
+		// Owners that are destroyed or pending kill are skipped without invoking anything, and dropped from the list.
+		UObject* object = listener.m_object.Get();
+		if (object == nullptr)
+		{
+			MarkListenerRemoved(listener);
+			continue;
+		}
+
+		object->ProcessEvent(listener.m_function, &params);
+	}
+
+	if (m_numSpatialListeners > 0 && m_locationArgIndex != INDEX_NONE)
+		m_manager->DispatchSpatial(*this, m_eventArgs[m_locationArgIndex].m_type.Get<FVector>());
+
+	m_delegate.Broadcast(*this);
+
+	if (m_dynamicDelegatePtr != nullptr)
+		m_dynamicDelegatePtr->Broadcast(this);
+
+	if (m_waiters != nullptr)
+		ResumeWaiters(false);
+
+	m_dispatchDepth--;
+
+	if (m_dispatchDepth == 0 && m_hasRemovedListeners)
+		CompactListeners();
+}
+
+void UGameEvent::ReplayLatched(int32 listenerIndex)
+{
+	if (!m_isLatched || !m_snapshot.load(std::memory_order_relaxed)->m_value.HasValue())
+		return;
+
+	// The arguments of the last broadcast are still in place, latched events always write them.
+	// Counts as a dispatch, so the listener can unbind itself right away.
+	m_dispatchDepth++;
+
+	FGameEventListener& listener = m_listeners[listenerIndex];
+	if (listener.m_native.IsBound())
+	{
+		listener.m_native.Execute(*this);
+	}
+	else if (UObject* object = listener.m_object.Get())
+	{
+		struct FListenerParams
+		{
+			UGameEvent* EventData;
+		};
+		FListenerParams params = { this };
+		object->ProcessEvent(listener.m_function, &params);
+	}
+
+	m_dispatchDepth--;
+
+	if (m_dispatchDepth == 0 && m_hasRemovedListeners)
+		CompactListeners();
+}
+
+void UGameEvent::CompactListeners()
+{
+	m_listeners.RemoveAll([](const FGameEventListener& listener) { return !listener.m_handle.IsValid(); });
+	m_hasRemovedListeners = false;
+}
+
+void UGameEvent::ResumeWaiters(bool cancel)
+{
+#if WITH_GAME_EVENT_COROUTINES
+	// Coroutines awaiting the event again while being resumed go to a fresh list, and wait for the next broadcast.
+	// If a resumed coroutine broadcasts this event again, the nested dispatch continues on the same list, so nobody is resumed twice.
+	FGameEventAwaiter* waiters = m_waiters;
+	m_waiters = nullptr;
+
+	if (m_resumingWaiters == nullptr)
+	{
+		m_resumingWaiters = waiters;
+	}
+	else if (waiters != nullptr)
+	{
+		FGameEventAwaiter* last = waiters;
+		while (last->m_next != nullptr)
+			last = last->m_next;
+		last->m_next = m_resumingWaiters;
+		m_resumingWaiters = waiters;
+	}
+
+	while (FGameEventAwaiter* waiter = m_resumingWaiters)
+	{
+		m_resumingWaiters = waiter->m_next;
+		waiter->m_next = nullptr;
+		waiter->m_linked = false;
+		if (cancel)
+			waiter->m_event = nullptr;
+		waiter->m_handle.resume();
+	}
+#endif
+}
+
+void UGameEvent::RemoveWaiter(FGameEventAwaiter* waiter)
+{
+#if WITH_GAME_EVENT_COROUTINES
+	for (FGameEventAwaiter** list : { &m_waiters, &m_resumingWaiters })
+	{
+		for (FGameEventAwaiter** it = list; *it != nullptr; it = &(*it)->m_next)
+		{
+			if (*it == waiter)
+			{
+				*it = waiter->m_next;
+				waiter->m_linked = false;
+				return;
+			}
+		}
+	}
+#endif
+}
+
+void UGameEvent::TakeWaiters(UGameEvent& from)
+{
+#if WITH_GAME_EVENT_COROUTINES
+	while (FGameEventAwaiter* waiter = from.m_waiters)
+	{
+		from.m_waiters = waiter->m_next;
+		waiter->m_event = this;
+		waiter->m_next = m_waiters;
+		m_waiters = waiter;
+	}
+#endif
+}
+
+void UGameEvent::OrphanWaiters()
+{
+#if WITH_GAME_EVENT_COROUTINES
+	const bool isTickerQueued = s_orphanedWaiters != nullptr;
+
+	while (FGameEventAwaiter* waiter = m_waiters)
+	{
+		m_waiters = waiter->m_next;
+		waiter->m_linked = false;
+		waiter->m_event = nullptr;
+		waiter->m_orphaned = true;
+		waiter->m_next = s_orphanedWaiters;
+		s_orphanedWaiters = waiter;
+	}
+
+	if (!isTickerQueued && s_orphanedWaiters != nullptr)
+		FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&UGameEvent::ResumeOrphanedWaiters));
+#endif
+}
+
+bool UGameEvent::ResumeOrphanedWaiters(float deltaTime)
+{
+#if WITH_GAME_EVENT_COROUTINES
+	while (FGameEventAwaiter* waiter = s_orphanedWaiters)
+	{
+		s_orphanedWaiters = waiter->m_next;
+		waiter->m_next = nullptr;
+		waiter->m_orphaned = false;
+		waiter->m_handle.resume();
+	}
+#endif
+
+	// One-shot, OrphanWaiters() queues a new ticker when needed.
+	return false;
+}
+
+void UGameEvent::RemoveOrphanedWaiter(FGameEventAwaiter* waiter)
+{
+#if WITH_GAME_EVENT_COROUTINES
+	for (FGameEventAwaiter** it = &s_orphanedWaiters; *it != nullptr; it = &(*it)->m_next)
+	{
+		if (*it == waiter)
+		{
+			*it = waiter->m_next;
+			waiter->m_orphaned = false;
+			return;
+		}
+	}
+#endif
+}
+
+void UGameEvent::AddReferencedObjects(UObject* inThis, FReferenceCollector& collector)
+{
+	Super::AddReferencedObjects(inThis, collector);
+
+	// Other events overwrite their arguments before anybody reads them again.
+	UGameEvent* ev = CastChecked<UGameEvent>(inThis);
+	if (ev->m_isLatched)
+	{
+		for (CEventArg& arg : ev->m_eventArgs)
+			AddReferencedArg(collector, arg.m_type);
+	}
+}
+
+void UGameEvent::BeginDestroy()
+{
+	// Don't leave coroutines suspended forever. The manager cancels them when it clears or reloads,
+	// this only catches events collected without that. Resuming gameplay code from within garbage collection isn't safe, so it's deferred.
+	if (m_waiters != nullptr)
+		OrphanWaiters();
+
+	Super::BeginDestroy();
+}
+
+void UGameEvent::MarkListenerRemoved(FGameEventListener& listener)
+{
+	listener.m_native.Unbind();
+	listener.m_object.Reset();
+	listener.m_function = nullptr;
+	listener.m_handle.Reset();
+	m_hasRemovedListeners = true;
+}
+
+UWaitForGameEventAction* UWaitForGameEventAction::WaitForGameEvent(UObject* worldContextObject, UGameEventManager* manager, FName id, float timeout, const TArray<FGameEventArgPredicate>& predicates)
+{
+	UWaitForGameEventAction* action = NewObject<UWaitForGameEventAction>();
+	action->m_manager = manager;
+	action->m_world = GEngine->GetWorldFromContextObject(worldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	action->m_id = id;
+	action->m_timeout = timeout;
+	action->m_predicates = predicates;
+	action->RegisterWithGameInstance(worldContextObject);
+	return action;
+}
+
+void UWaitForGameEventAction::Activate()
+{
+	bool success = false;
+	FGameEventHandle handle = m_manager != nullptr ? m_manager->ResolveEvent(m_id, success) : FGameEventHandle();
+	if (!success)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Wait For Game Event failed, event '%s' doesn't exist."), *m_id.ToString());
+		SetReadyToDestroy();
+		return;
+	}
+
+	m_event = &m_manager->Get(handle);
+
+	// Parse the predicates once, matching them is then a plain compare per argument.
+	for (const FGameEventArgPredicate& predicate : m_predicates)
+	{
+		const int32 index = m_event->FindArgIndex(predicate.m_arg);
+		EventArgType value;
+		if (index == INDEX_NONE || !m_event->ParseArgValue(index, predicate.m_value, value))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Wait For Game Event failed, predicate on '%s' doesn't fit event '%s'."), *predicate.m_arg.ToString(), *m_id.ToString());
+			SetReadyToDestroy();
+			return;
+		}
+
+		m_conditions.Emplace(index, value);
+	}
+
+	// Waits for the next broadcast, the latched value of a latched event doesn't count.
+	m_listenerHandle = m_event->AddListener(FGameEventDelegate::FDelegate::CreateUObject(this, &UWaitForGameEventAction::HandleEvent), false);
+
+	if (m_timeout > 0.0f && m_world.IsValid())
+		m_world->GetTimerManager().SetTimer(m_timeoutHandle, FTimerDelegate::CreateUObject(this, &UWaitForGameEventAction::HandleTimeout), m_timeout, false);
+}
+
+void UWaitForGameEventAction::HandleEvent(UGameEvent& ev)
+{
+	for (const TPair<int32, EventArgType>& condition : m_conditions)
+	{
+		if (!ev.ArgEquals(condition.Key, condition.Value))
+			return;
+	}
+
+	Finish();
+	OnEvent.Broadcast(&ev);
+}
+
+void UWaitForGameEventAction::HandleTimeout()
+{
+	m_timeoutHandle.Invalidate();
+	Finish();
+	OnTimeout.Broadcast(m_event);
+}
+
+void UWaitForGameEventAction::Finish()
+{
+	// One-shot, remove the listener right away. Removing it from within the dispatch is safe.
+	if (m_event != nullptr)
+		m_event->RemoveListener(m_listenerHandle);
+	m_listenerHandle.Reset();
+
+	if (m_timeoutHandle.IsValid() && m_world.IsValid())
+		m_world->GetTimerManager().ClearTimer(m_timeoutHandle);
+
+	SetReadyToDestroy();
+}
+
+#if WITH_GAME_EVENT_COROUTINES
+
+FGameEventCoroutinePool::FFreeBlock* FGameEventCoroutinePool::s_freeLists[FGameEventCoroutinePool::NumSizeClasses] = {};
+
+void* FGameEventCoroutinePool::Allocate(SIZE_T size)
+{
+	const int32 sizeClass = GetSizeClass(size);
+	if (sizeClass == INDEX_NONE)
+		return FMemory::Malloc(size);
+
+	if (FFreeBlock* block = s_freeLists[sizeClass])
+	{
+		s_freeLists[sizeClass] = block->m_next;
+		return block;
+	}
+
+	return FMemory::Malloc(SIZE_T(128) << sizeClass);
+}
+
+void FGameEventCoroutinePool::Free(void* ptr, SIZE_T size)
+{
+	const int32 sizeClass = GetSizeClass(size);
+	if (sizeClass == INDEX_NONE)
+	{
+		FMemory::Free(ptr);
+		return;
+	}
+
+	// Blocks are kept for the next frame of the same size class, they are never given back.
+	FFreeBlock* block = static_cast<FFreeBlock*>(ptr);
+	block->m_next = s_freeLists[sizeClass];
+	s_freeLists[sizeClass] = block;
+}
+
+int32 FGameEventCoroutinePool::GetSizeClass(SIZE_T size)
+{
+	for (int32 i = 0; i < NumSizeClasses; i++)
+	{
+		if (size <= (SIZE_T(128) << i))
+			return i;
+	}
+
+	return INDEX_NONE;
+}
+
+#endif
@@ -35,9 +35,35 @@
 #include "Engine/DataTable.h"
 #include "Delegates/DelegateCombinations.h"
 #include "UObject/NoExportTypes.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "Tickable.h"
+#include <atomic>
 #include "GameEventManager.generated.h"
 
+// Awaitable events need C++20 coroutines, the module has to be compiled with CppStandard = CppStandardVersion.Cpp20.
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define WITH_GAME_EVENT_COROUTINES 1
+#include <coroutine>
+#else
+#define WITH_GAME_EVENT_COROUTINES 0
+#endif
+
 class UDataTable;
+struct FGameEventAwaiter;
+
+/**
+* Priority class of an event, decides how broadcasts queued with UGameEventManager::BroadcastDeferred() are dispatched.
+*/
+UENUM(BlueprintType)
+enum class EGameEventPriority : uint8
+{
+	/// Never deferred, deferred broadcasts are dispatched right away.
+	Critical,
+	/// Dispatched within the frame budget, before any low priority event.
+	Normal,
+	/// Dispatched with what's left of the frame budget.
+	Low
+};
 
 /**
 * Event argument types, used to define arguments in Data table.
@@ -74,6 +100,104 @@ struct FEventArgStruct
 */
 typedef TVariant<int, float, double, FString, FName, bool, FVector, FVector2D, FRotator, UObject*, AActor*, uint8, FEventArgStruct*> EventArgType;
 
+/**
+* Minimal perfect hash over a fixed set of names, built with hash & displace.
+* Every key gets its own slot, so a lookup is always a single probe plus one FName compare to reject unknown names.
+* Event names and argument names never change after Setup(), which is what makes this possible.
+*/
+struct FGameEventNameHash
+{
+public:
+	/// Builds the hash over the given unique keys. Find() returns the index of a key in this array.
+	void Build(const TArray<FName>& keys);
+
+	/// Same as Build(), but if the key set didn't change the seeds are kept and only the indices are remapped.
+	void Rebuild(const TArray<FName>& keys);
+
+	void Reset();
+
+	FORCEINLINE int32 Find(const FName& key) const
+	{
+		const int32 slot = FindSlot(key);
+		if (slot != INDEX_NONE)
+			return m_values[slot];
+		return m_collisions.Num() == 0 ? INDEX_NONE : FindCollision(key);
+	}
+
+	FORCEINLINE int32 Num() const { return m_keys.Num() + m_collisions.Num(); }
+
+private:
+	/// GetTypeHash(FName) adds the number to the comparison index, so "A_1" and "B_0" can share it. Hash both parts instead.
+	static FORCEINLINE uint32 KeyHash(const FName& key)
+	{
+		return HashCombine(GetTypeHash(key.GetComparisonIndex()), key.GetNumber());
+	}
+
+	FORCEINLINE int32 FindSlot(const FName& key) const
+	{
+		if (m_keys.Num() == 0)
+			return INDEX_NONE;
+
+		const uint32 hash = KeyHash(key);
+		const int32 slot = Slot(hash, m_seeds[Bucket(hash)]);
+		return m_keys[slot] == key ? slot : INDEX_NONE;
+	}
+
+	int32 FindCollision(const FName& key) const;
+
+	static FORCEINLINE uint32 Mix(uint32 hash, uint32 seed)
+	{
+		// Murmur3 finalizer. FName hashes are name table indices, they need some scrambling before they can be bucketed.
+		uint32 h = hash ^ (seed * 0x9E3779B9u);
+		h ^= h >> 16;
+		h *= 0x85EBCA6Bu;
+		h ^= h >> 13;
+		h *= 0xC2B2AE35u;
+		h ^= h >> 16;
+		return h;
+	}
+
+	FORCEINLINE uint32 Bucket(uint32 hash) const { return Mix(hash, 0) & m_bucketMask; }
+	FORCEINLINE int32 Slot(uint32 hash, uint32 seed) const { return static_cast<int32>(Mix(hash, seed) % static_cast<uint32>(m_keys.Num())); }
+
+private:
+	TArray<uint32> m_seeds;
+	TArray<FName> m_keys;
+	TArray<int32> m_values;
+	uint32 m_bucketMask = 0;
+
+	/// Keys whose hash equals the hash of a key in the table. No seed can separate those, they are searched linearly instead.
+	TArray<TPair<FName, int32>> m_collisions;
+};
+
+struct FGameEventRegistryEntry;
+
+/**
+* Prefix tree over the dot separated segments of event names, e.g. Combat.Damage.Headshot.
+* Only used to resolve wildcard subscriptions when they are made, never during dispatch.
+*/
+struct PROJECTSNIPER_API FGameEventNameTrie
+{
+public:
+	void Build(const TArray<FGameEventRegistryEntry>& registry);
+	void Reset();
+
+	/// Collects the registry index of every event matching the pattern. "Combat.Damage.*" matches every event under Combat.Damage,
+	/// "*" matches every event, and a pattern without a wildcard matches that event only. Fails for wildcards anywhere but at the end.
+	bool Match(const FString& pattern, TArray<int32>& outIndices) const;
+
+private:
+	void Collect(int32 node, TArray<int32>& outIndices) const;
+
+	struct FNode
+	{
+		TMap<FName, int32> m_children;
+		int32 m_event = INDEX_NONE;
+	};
+
+	TArray<FNode> m_nodes;
+};
+
 /**
 * Wrapper for an event argument. Defines the name of the argument as well as it's type.
 */
@@ -106,246 +230,1600 @@ public:
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "Event Args"))
 	TMap<FName, EEventArgTypes> m_args;
-};
 
-/**
-* All events use the same delegate structure.
-*/
-class UGameEvent;
-DECLARE_MULTICAST_DELEGATE_OneParam(FGameEventDelegate, UGameEvent&);
+	/// Optional group name, whole categories can be enabled/disabled at runtime.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "Category"))
+	FName m_category = "";
+
+	/// Latched events keep the arguments of their last broadcast, and deliver them to every new listener right away.
+	/// Use it for state, e.g. OnScoreChanged, so late listeners don't need to reconstruct it.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "Is Latched?"))
+	bool m_isLatched = false;
+
+	/// Keeps a packed copy of the last arguments that any thread can read, e.g. the audio thread reading OnExplosion positions.
+	/// Latched events always do.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "Publish Latest Value?"))
+	bool m_publishLatest = false;
+
+	/// Number of past broadcasts to keep, for debug overlays or systems processing the event every few frames. Zero keeps none.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "History Size", ClampMin = "0"))
+	int32 m_historySize = 0;
+
+	/// FVector argument holding where the event happens. Listeners bound with UGameEventManager::AddSpatialListener() are only called for broadcasts within their radius.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "Location Argument"))
+	FName m_locationArg = "";
+
+	/// How deferred broadcasts of the event are dispatched, see UGameEventManager::BroadcastDeferred(). Regular broadcasts are always dispatched right away.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "Priority"))
+	EGameEventPriority m_priority = EGameEventPriority::Normal;
+};
 
 /**
-* The actual parameter type passed through game events.
-* This type contains a list of arguments, that are set according to the DataTable.
-* We use Broadcast() method to broadcast a template parameter pack as the arguments.
-* If the system detects the order and the type of arguments do not match to the ones defined in DataTable
-* It logs an error, and does not broadcast the actual delegate.
+* Flattened form of a single DataTable row.
+* The manager bakes these when it is saved or cooked, so Setup() doesn't need to walk the DataTable at all.
+* Arguments of all events are stored back to back in the manager, an entry only points to its range.
 */
-UCLASS(BlueprintType, Blueprintable)
-class UGameEvent : public UObject
+USTRUCT()
+struct FGameEventRegistryEntry
 {
 	GENERATED_BODY()
 
 public:
-	UGameEvent()
-	{
-	};
+	UPROPERTY()
+	FName m_name = "";
 
-	virtual ~UGameEvent()
-	{
-	};
+	UPROPERTY()
+	bool m_isDynamic = false;
 
-	void Broadcast()
-	{
-		BroadcastDelegate();
-	}
+	UPROPERTY()
+	FName m_category = "";
 
-	FORCEINLINE FGameEventDelegate& GetDelegate() { return m_delegate; }
+	UPROPERTY()
+	bool m_isLatched = false;
 
-	template <typename T, typename ... Args>
-	void Broadcast(T t, Args ... args)
-	{
-		SetValues(t, args...);
+	UPROPERTY()
+	bool m_publishLatest = false;
 
-		if (m_argsCounter == -1 || m_argsCounter < m_eventArgs.Num())
-		{
-			UE_LOG(LogTemp, Error, TEXT("Broadcast of Event '%s' failed. Args Counter: %d, Event Args Num: %d"),
-			       *m_name.ToString(), m_argsCounter, m_eventArgs.Num());
-		}
+	UPROPERTY()
+	int32 m_historySize = 0;
 
-		m_argsCounter = 0;
-	}
+	UPROPERTY()
+	FName m_locationArg = "";
 
-	template <typename T, typename ... Args>
-	void SetValues(T t, Args ... args)
-	{
-		if (m_argsCounter != -1)
-		{
-			SetValues(t);
-			SetValues(args...);
-		}
-	}
+	UPROPERTY()
+	EGameEventPriority m_priority = EGameEventPriority::Normal;
 
-	/// Actual method where we set the individual params inside the sent param pack to Broadcast()
-	template <typename T>
-	void SetValues(T arg)
-	{
-		if (m_argsCounter == -1)
-			return;
+	UPROPERTY()
+	int32 m_firstArg = 0;
 
-		// Create a temporary type list, set it's type to T.
-		EventArgType tempType;
-		tempType.Set<T>(arg);
+	UPROPERTY()
+	int32 m_numArgs = 0;
+};
 
-		// Get the actual set type in the current argument we are supposed to set.
-		// If the type indices don't match, abort.
-		CEventArg& eventArg = m_eventArgs[m_argsCounter];
-		if (eventArg.m_type.GetIndex() == tempType.GetIndex())
-		{
-			eventArg.m_type.Set<T>(arg);
-			CheckArgsCounter();
-		}
-		else
-		{
-			UE_LOG(LogTemp, Error, TEXT("Broadcast mismatch found in event '%s' between the sent argument and '%s'"),
-			       *m_name.ToString(), *eventArg.m_name.ToString());
-			m_argsCounter = -1;
-		}
-	}
+/**
+* One step of the 64-bit FNV-1a hash over the argument type indices of a signature.
+* Used both at compile time for the template parameter packs, and at runtime for the schema of each event.
+*/
+constexpr uint64 HashGameEventSignatureStep(uint64 hash, SIZE_T typeIndex)
+{
+	return (hash ^ static_cast<uint64>(typeIndex + 1)) * 1099511628211ull;
+}
 
-	template <typename T>
-	T GetValue(const FName& id)
-	{
-		CEventArg* found = m_eventArgs.FindByPredicate([id](const CEventArg& arg) { return arg.m_name == id; });
+constexpr uint64 GameEventSignatureHashBasis = 14695981039346656037ull;
 
-		if (found == nullptr)
-		{
-			UE_LOG(LogTemp, Error, TEXT("Variable '%s' could not be found in event '%s'"), *id.ToString(), *m_name.ToString());
-			return T();
-		}
+template <typename ... Ts>
+constexpr uint64 GameEventSignatureHash()
+{
+	uint64 hash = GameEventSignatureHashBasis;
+	((hash = HashGameEventSignatureStep(hash, EventArgType::IndexOfType<Ts>())), ...);
+	return hash;
+}
 
-		// Create a temporary type list, set it's type to T.
-		EventArgType tempType;
-		tempType.Set<T>(T());
-		
-		if (found->m_type.GetIndex() == tempType.GetIndex())
-		{
-			return found->m_type.Get<T>();
-		}
-		else
-		{
-			UE_LOG(LogTemp, Error, TEXT("Requested variable '%s' in event '%s' with the wrong type!"), *id.ToString(), *m_name.ToString());
-			return T();
-		}
-		
-	}
+/**
+* Compile time description of an argument list, used to check it against the arguments of an event.
+*/
+template <typename ... Ts>
+struct TGameEventSignature
+{
+	/// Variant type index of every type. The trailing element keeps the array valid for empty lists.
+	static constexpr SIZE_T TypeIndices[] = { EventArgType::IndexOfType<Ts>()..., 0 };
+	static constexpr int32 Num = sizeof...(Ts);
 
-	UFUNCTION(BlueprintCallable)
-	int GetInt(FName id)
-	{
-		return GetValue<int>(id);
-	}
+	/// Compared against UGameEvent::m_signatureHash, validating a whole signature is a single integer compare regardless of arity.
+	static constexpr uint64 Hash = GameEventSignatureHash<Ts...>();
+};
 
-	UFUNCTION(BlueprintCallable)
-	float GetFloat(FName id)
-	{
-		return GetValue<float>(id);
-	}
+/**
+* Resolved reference to an event, cheap to store and to resolve again.
+* Resolve it once, e.g. in BeginPlay, keep it in a variable and use it instead of the event name in per-frame code.
+* Handles survive Reload(). If the event moved in the registry, the handle finds it again by name and updates itself.
+*/
+USTRUCT(BlueprintType)
+struct FGameEventHandle
+{
+	GENERATED_BODY()
 
+public:
+	FORCEINLINE bool IsValid() const { return m_index != INDEX_NONE; }
 
-	UFUNCTION(BlueprintCallable)
-	bool GetBool(FName id)
-	{
-		return GetValue<bool>(id);
-	}
+	UPROPERTY()
+	int32 m_index = INDEX_NONE;
 
-	UFUNCTION(BlueprintCallable)
-	FVector GetFVector(FName id)
-	{
-		return GetValue<FVector>(id);
-	}
+	UPROPERTY()
+	FName m_name = "";
+};
 
-	UFUNCTION(BlueprintCallable)
-	FVector2D GetFVector2D(FName id)
-	{
-		return GetValue<FVector2D>(id);
-	}
+/**
+* Condition on an argument value, used by Wait For Game Event.
+* The value is written as text and parsed into the argument's type once, when the wait starts.
+*/
+USTRUCT(BlueprintType)
+struct FGameEventArgPredicate
+{
+	GENERATED_BODY()
 
-	UFUNCTION(BlueprintCallable)
-	FRotator GetFRotator(FName id)
-	{
-		return GetValue<FRotator>(id);
-	}
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "Argument"))
+	FName m_arg = "";
 
-	UFUNCTION(BlueprintCallable)
-	UObject* GetUObject(FName id)
-	{
-		return GetValue<UObject*>(id);
-	}
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "Value"))
+	FString m_value;
+};
 
-	UFUNCTION(BlueprintCallable)
-	AActor* GetActor(FName id)
-	{
-		return GetValue<AActor*>(id);
-	}
+/**
+* Fixed capacity string, the packed form of FString arguments. Longer strings are truncated.
+*/
+struct FGameEventPackedString
+{
+	static constexpr int32 Capacity = 64;
 
-	FEventArgStruct* GetStruct(FName id)
-	{
-		return GetValue<FEventArgStruct*>(id);
-	}
+	int32 m_len = 0;
+	TCHAR m_chars[Capacity];
+};
 
-	UFUNCTION(BlueprintCallable)
-	uint8 GetUEnum(FName id)
+/**
+* Layout of the packed form of an event's arguments: every argument at a fixed offset in one flat, trivially copyable buffer.
+* Packed arguments can be copied around with a single memcpy, and read on any thread since nothing in them is owned.
+* Object arguments are stored as plain pointers, reading them off the game thread is fine but dereferencing them isn't.
+*/
+struct PROJECTSNIPER_API FGameEventPackedLayout
+{
+public:
+	void Build(const TArray<CEventArg>& args);
+	void Pack(const TArray<CEventArg>& args, uint8* dest) const;
+
+	FORCEINLINE int32 Num() const { return m_offsets.Num(); }
+	FORCEINLINE int32 GetSize() const { return m_size; }
+	FORCEINLINE SIZE_T GetTypeIndex(int32 index) const { return m_typeIndices[index]; }
+
+	/// Reads an argument out of a packed buffer. Fails if the index is out of range or T isn't the argument's type.
+	template <typename T>
+	bool Read(const uint8* packed, int32 index, T& out) const
 	{
-		return GetValue<uint8>(id);
-	}
+		if (!m_offsets.IsValidIndex(index) || m_typeIndices[index] != EventArgType::IndexOfType<T>())
+			return false;
 
-protected:
-	virtual void BroadcastDelegate();
+		if constexpr (TIsSame<T, FString>::Value)
+		{
+			FGameEventPackedString str;
+			FMemory::Memcpy(&str, packed + m_offsets[index], sizeof(FGameEventPackedString));
+			out = FString(str.m_len, str.m_chars);
+		}
+		else
+		{
+			FMemory::Memcpy(&out, packed + m_offsets[index], sizeof(T));
+		}
 
-private:
-	void CheckArgsCounter();
+		return true;
+	}
+
+	/// Formats an argument out of a packed buffer for display. Objects are shown by address, they might be gone already.
+	FString DescribeArg(const uint8* packed, int32 index) const;
 
 private:
-	friend class UGameEventManager;
-	TArray<CEventArg> m_eventArgs;
-	FGameEventDelegate m_delegate;
-	int m_argsCounter = 0;
-	FName m_name = "";
+	TArray<int32> m_offsets;
+	TArray<SIZE_T> m_typeIndices;
+	int32 m_size = 0;
 };
 
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FGameEventDelegateDynamic, UGameEvent*, EventData);
-
 /**
-* Same as UGameEvent, however this sub-class casts a dynamic delegate instead of a non-dynamic.
-* Use only for the events that you want to listen through blueprints, instead of C++ code. ( you can also listen these in C++ )
+* Packed arguments guarded by a double buffered sequence lock: a single writer on the game thread, any number of readers on any thread.
+* Writes alternate between two buffers, so a reader always copies a completed value, even while the next write is in progress.
+* Neither side ever waits. A reader only retries if two more writes start during its copy.
 */
-UCLASS(BlueprintType, Blueprintable)
-class UGameEventDynamic : public UGameEvent
+struct PROJECTSNIPER_API FGameEventSeqLock
 {
-	GENERATED_BODY()
-
 public:
-	UGameEventDynamic()
-	{
-	};
+	/// Sizes the buffers and drops the value. Game thread only, and not while other threads read.
+	void Reset(int32 size);
 
-	virtual ~UGameEventDynamic() override
-	{
-	};
+	void Write(const FGameEventPackedLayout& layout, const TArray<CEventArg>& args);
 
-	FORCEINLINE FGameEventDelegateDynamic& GetDynDelegate() { return m_dynamicDelegate; }
+	/// Copies the value into dest, which must hold the layout's size. False if nothing was written yet.
+	bool Read(uint8* dest) const;
 
-	UPROPERTY(BlueprintAssignable)
-	FGameEventDelegateDynamic m_dynamicDelegate;
+	FORCEINLINE bool HasValue() const { return m_published.load(std::memory_order_acquire) != 0; }
 
-protected:
-	virtual void BroadcastDelegate() override;
+private:
+	/// Number of writes started and completed. Write n goes to buffer n & 1, zero means nothing was written yet.
+	std::atomic<uint32> m_started { 0 };
+	std::atomic<uint32> m_published { 0 };
+	int32 m_size = 0;
+	TArray<uint8> m_data;
 };
 
+/**
+* Packed layout of an event along with its latest value. When a reload changes the arguments, the event publishes a new snapshot
+* instead of rebuilding this one in place, so readers on other threads always decode a value with the layout it was written with.
+*/
+struct FGameEventLatestSnapshot
+{
+	FGameEventPackedLayout m_layout;
+	FGameEventSeqLock m_value;
+};
 
 /**
- * Handles the initialization & management of events.
- */
-UCLASS(BlueprintType, Blueprintable)
-class PROJECTSNIPER_API UGameEventManager : public UObject
+* A past broadcast kept in an event's history. The arguments point into the history, decode them with the event's packed layout.
+*/
+struct FGameEventHistoryRecord
 {
-	GENERATED_BODY()
+	uint64 m_frame = 0;
+	double m_time = 0.0;
+	const uint8* m_args = nullptr;
+};
 
+/**
+* Ring of the last broadcasts of an event, in packed form, along with the frame number and time they happened at.
+* All memory is allocated up front, recording a broadcast is a single pack into the next slot.
+* Records are numbered in the order they were recorded. Systems processing the event lazily keep the number they stopped at,
+* and pick up from there: for (uint64 n = FMath::Max(last, history.GetFirstNumber()); n < history.GetNumRecorded(); n++).
+* Game thread only.
+*/
+struct PROJECTSNIPER_API FGameEventHistory
+{
 public:
-	
-	void Setup();
-	void Clear();
+	/// Allocates room for capacity records and drops every record.
+	void Reset(int32 capacity, int32 packedSize);
 
-	UFUNCTION(BlueprintCallable)
+	void Record(const FGameEventPackedLayout& layout, const TArray<CEventArg>& args);
+
+	FORCEINLINE int32 GetCapacity() const { return m_capacity; }
+
+	/// Number of records currently held, at most the capacity.
+	FORCEINLINE int32 Num() const { return static_cast<int32>(FMath::Min<uint64>(m_numRecorded, m_capacity)); }
+
+	/// Number of broadcasts recorded so far, one past the number of the newest record.
+	FORCEINLINE uint64 GetNumRecorded() const { return m_numRecorded; }
+
+	/// Number of the oldest record still held.
+	FORCEINLINE uint64 GetFirstNumber() const { return m_numRecorded - Num(); }
+
+	/// Returns false if the record was overwritten already, or hasn't been recorded yet.
+	bool GetRecord(uint64 number, FGameEventHistoryRecord& outRecord) const;
+
+private:
+	struct FHeader
+	{
+		uint64 m_frame;
+		double m_time;
+	};
+
+	TArray<uint8> m_data;
+	int32 m_capacity = 0;
+	int32 m_stride = 0;
+	uint64 m_numRecorded = 0;
+};
+
+/**
+* All events use the same delegate structure.
+*/
+class UGameEvent;
+DECLARE_MULTICAST_DELEGATE_OneParam(FGameEventDelegate, UGameEvent&);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FGameEventDelegateDynamic, UGameEvent*, EventData);
+DECLARE_DYNAMIC_DELEGATE_OneParam(FGameEventListenerDynamic, UGameEvent*, EventData);
+
+/**
+* A single listener of an event, either a native delegate or a Blueprint one.
+* Both kinds live in the same list and are dispatched in one pass, native listeners are called directly and never go through reflection.
+*/
+struct FGameEventListener
+{
+	FGameEventDelegate::FDelegate m_native;
+
+	/// Blueprint listeners. The function is resolved once when binding, a script delegate would look it up by name on every call.
+	TWeakObjectPtr<UObject> m_object;
+	UFunction* m_function = nullptr;
+
+	FDelegateHandle m_handle;
+};
+
+/**
+* Refers to a listener bound with UGameEventManager::AddSpatialListener(), used to move or remove it.
+* Stays safe to use after the listener was removed, listener slots are reused with a new serial.
+*/
+USTRUCT(BlueprintType)
+struct FGameEventSpatialHandle
+{
+	GENERATED_BODY()
+
+public:
+	FORCEINLINE bool IsValid() const { return m_index != INDEX_NONE; }
+
+	UPROPERTY()
+	int32 m_index = INDEX_NONE;
+
+	UPROPERTY()
+	int32 m_serial = 0;
+};
+
+/**
+* A listener only interested in broadcasts near a position, see UGameEventManager::AddSpatialListener().
+*/
+struct FGameEventSpatialListener
+{
+	FGameEventListener m_listener;
+
+	/// Null while the slot is free.
+	UGameEvent* m_event = nullptr;
+	FVector m_position = FVector::ZeroVector;
+	float m_radius = 0.0f;
+
+	/// Grid cells the listener is linked into, the oversized cell if it spans too many of them.
+	FIntVector m_minCell = FIntVector::ZeroValue;
+	FIntVector m_maxCell = FIntVector::ZeroValue;
+
+	/// LOD, see UGameEventManager::m_lodTiers. Low significance makes the listener count as further away.
+	bool m_useLod = true;
+	float m_significance = 1.0f;
+	uint64 m_lastDeliveryFrame = 0;
+
+	/// Latest broadcast held back by the LOD, and how many broadcasts it stands for. Delivered once m_pendingDueFrame is reached.
+	TArray<CEventArg> m_pendingArgs;
+	uint64 m_pendingSignatureHash = 0;
+	uint64 m_pendingDueFrame = 0;
+	int32 m_pendingCount = 0;
+
+	int32 m_serial = 1;
+	int32 m_nextFree = INDEX_NONE;
+};
+
+/**
+* A delivery rate tier for spatial listeners far away from the event.
+*/
+USTRUCT(BlueprintType)
+struct FGameEventLodTier
+{
+	GENERATED_BODY()
+
+public:
+	/// Listeners at least this far from the broadcast, after dividing by their significance, fall into this tier. The furthest matching tier wins.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "Min Distance", ClampMin = "0"))
+	float m_minDistance = 0.0f;
+
+	/// Listeners are called at most once every this many frames. Broadcasts in between are coalesced into a single call with the latest arguments.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (DisplayName = "Frame Interval", ClampMin = "1"))
+	int32 m_frameInterval = 1;
+};
+
+/**
+* Counters of the LOD of spatial listeners, see UGameEventManager::GetLodStats().
+*/
+USTRUCT(BlueprintType)
+struct FGameEventLodStats
+{
+	GENERATED_BODY()
+
+public:
+	/// Calls of spatial listeners, immediate or coalesced.
+	UPROPERTY(BlueprintReadOnly, meta = (DisplayName = "Delivered"))
+	int64 m_delivered = 0;
+
+	/// Broadcasts held back by the LOD instead of being delivered right away.
+	UPROPERTY(BlueprintReadOnly, meta = (DisplayName = "Coalesced"))
+	int64 m_coalesced = 0;
+
+	/// Listener calls that never happened, because several broadcasts were coalesced into one call or superseded by a newer one.
+	UPROPERTY(BlueprintReadOnly, meta = (DisplayName = "Saved"))
+	int64 m_saved = 0;
+};
+
+/**
+* Key of the spatial grid: a cell of the grid of a single event.
+*/
+struct FGameEventSpatialCell
+{
+	const UGameEvent* m_event = nullptr;
+	FIntVector m_cell = FIntVector::ZeroValue;
+
+	FORCEINLINE bool operator==(const FGameEventSpatialCell& other) const { return m_event == other.m_event && m_cell == other.m_cell; }
+
+	friend FORCEINLINE uint32 GetTypeHash(const FGameEventSpatialCell& key)
+	{
+		return HashCombine(PointerHash(key.m_event), GetTypeHash(key.m_cell));
+	}
+};
+
+/**
+* A listener bound to every event matching a pattern, see UGameEventManager::AddWildcardListener().
+* It's copied into the listener list of every matching event, all copies share the handle.
+*/
+struct FGameEventWildcardListener
+{
+	FString m_pattern;
+	FGameEventListener m_listener;
+};
+
+/**
+* The actual parameter type passed through game events.
+* This type contains a list of arguments, that are set according to the DataTable.
+* We use Broadcast() method to broadcast a template parameter pack as the arguments.
+* If the system detects the order and the type of arguments do not match to the ones defined in DataTable
+* It logs an error, and does not broadcast the actual delegate.
+*/
+UCLASS(BlueprintType, Blueprintable, MinimalAPI)
+class UGameEvent : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UGameEvent()
+	{
+	};
+
+	virtual ~UGameEvent()
+	{
+	};
+
+	void Broadcast()
+	{
+		if (!IsEnabled())
+			return;
+
+		BroadcastDelegate();
+	}
+
+	/// Disabled events ignore every broadcast, see UGameEventManager::SetEventEnabled().
+	FORCEINLINE bool IsEnabled() const { return (*m_enabledWord & m_enabledBit) != 0; }
+
+	/// Binds a native listener, e.g. AddListener(FGameEventDelegate::FDelegate::CreateUObject(this, &UMyClass::OnEvent)).
+	/// If the event is latched and was broadcast before, the listener is called right away with the last arguments, unless replayLatched is false.
+	FDelegateHandle AddListener(FGameEventDelegate::FDelegate&& listener, bool replayLatched = true);
+
+	void RemoveListener(FDelegateHandle handle);
+
+	/// Binds a Blueprint listener. Unlike binding to m_dynamicDelegate, this works for every event and shares the listener list with native listeners.
+	UFUNCTION(BlueprintCallable)
+	void Listen(const FGameEventListenerDynamic& listener);
+
+	UFUNCTION(BlueprintCallable)
+	void StopListening(const FGameEventListenerDynamic& listener);
+
+	/// Multicast delegate bindings are kept for existing code, and are dispatched along with the listener list.
+	/// Prefer AddListener() or Subscribe() for new code.
+	FORCEINLINE FGameEventDelegate& GetDelegate() { return m_delegate; }
+
+	UFUNCTION(BlueprintPure)
+	bool IsDynamic() const { return m_isDynamic; }
+
+	UFUNCTION(BlueprintPure)
+	bool IsLatched() const { return m_isLatched; }
+
+	/// Number of broadcasts the current call stands for. Above one when the LOD of a spatial listener coalesced several broadcasts, the arguments are the latest ones.
+	UFUNCTION(BlueprintPure)
+	int32 GetCoalescedCount() const { return m_coalescedCount; }
+
+	/// True if the event keeps a packed copy of its last arguments, either because it's latched or because it publishes them.
+	FORCEINLINE bool StoresLatest() const { return m_storesLatest; }
+
+	/// Copies the packed arguments of the last broadcast, see StoresLatest(). Safe to call from any thread, it never blocks the broadcaster.
+	/// Returns false if the event doesn't store them or wasn't broadcast yet. Decode the values with the layout written to outLayout,
+	/// which stays valid as long as the event, even if a reload changes the arguments in the meantime.
+	bool ReadLatest(TArray<uint8>& outPacked, const FGameEventPackedLayout** outLayout = nullptr) const;
+
+	/// Reads a single argument of the last broadcast, from any thread. Payloads up to 256 bytes are copied on the stack.
+	template <typename T>
+	bool ReadLatestArg(int32 index, T& out) const
+	{
+		const FGameEventLatestSnapshot* snapshot = m_snapshot.load(std::memory_order_acquire);
+		if (snapshot == nullptr)
+			return false;
+
+		TArray<uint8, TInlineAllocator<256>> packed;
+		packed.SetNumUninitialized(snapshot->m_layout.GetSize());
+		return snapshot->m_value.Read(packed.GetData()) && snapshot->m_layout.Read(packed.GetData(), index, out);
+	}
+
+	/// Changes only when the table is reloaded. Other threads decode with the layout ReadLatest() hands out instead.
+	/// Empty for events that neither store their latest value nor record a history, they never pack their arguments.
+	FORCEINLINE const FGameEventPackedLayout& GetPackedLayout() const
+	{
+		const FGameEventLatestSnapshot* snapshot = m_snapshot.load(std::memory_order_relaxed);
+		return snapshot != nullptr ? snapshot->m_layout : s_emptyLayout;
+	}
+
+	/// Past broadcasts of the event, null unless the row has a history size.
+	FORCEINLINE const FGameEventHistory* GetHistory() const { return m_history.Get(); }
+
+	/// Binds a listener that receives the arguments directly instead of the event, e.g. Subscribe<FName, int>([](const FName& item, int amount){ ... });
+	/// The signature is checked against the table here. If it doesn't match, nothing is bound and the returned handle is invalid.
+	/// It's checked again on every call, a reload can change the arguments of the event while the listener stays bound. The listener is skipped then.
+	template <typename ... Ts, typename F>
+	FDelegateHandle Subscribe(F&& listener)
+	{
+		if (!MatchesSignature<Ts...>())
+		{
+			ReportSignatureMismatch(TEXT("Subscribe"), TGameEventSignature<Ts...>::TypeIndices, TGameEventSignature<Ts...>::Num);
+			return FDelegateHandle();
+		}
+
+		return AddListener(FGameEventDelegate::FDelegate::CreateLambda([listener = Forward<F>(listener)](UGameEvent& ev) mutable
+		{
+			if (!ev.MatchesSignature<Ts...>())
+			{
+				ev.ReportSignatureMismatch(TEXT("Subscribed listener"), TGameEventSignature<Ts...>::TypeIndices, TGameEventSignature<Ts...>::Num);
+				return;
+			}
+
+			ev.InvokeUnpacked<Ts...>(listener, TMakeIntegerSequence<uint32, sizeof...(Ts)>());
+		}));
+	}
+
+	FORCEINLINE void Unsubscribe(FDelegateHandle handle) { RemoveListener(handle); }
+
+	/// True if the given types match the number, order and types of the arguments defined in the table.
+	template <typename ... Ts>
+	FORCEINLINE bool MatchesSignature() const
+	{
+		return TGameEventSignature<Ts...>::Hash == m_signatureHash;
+	}
+
+	/// Arguments are forwarded all the way into the argument storage, rvalues are moved in and never copied.
+	/// The whole signature is validated before anything is written, so a mismatching broadcast leaves the previous values intact.
+	template <typename T, typename ... Args>
+	void Broadcast(T&& t, Args&& ... args)
+	{
+		typedef TGameEventSignature<typename TDecay<T>::Type, typename TDecay<Args>::Type...> Signature;
+
+		if (!IsEnabled())
+			return;
+
+		if (Signature::Hash != m_signatureHash)
+		{
+			ReportSignatureMismatch(TEXT("Broadcast"), Signature::TypeIndices, Signature::Num);
+			return;
+		}
+
+		// Nobody would see the values, skip writing them.
+		if (!NeedsValues())
+			return;
+
+		SetValues(Forward<T>(t), Forward<Args>(args)...);
+		BroadcastDelegate();
+	}
+
+	/// Same as Broadcast(), but takes callables that return the arguments, e.g. BroadcastLazy([&]{ return FString::Printf(...); });
+	/// The callables are only invoked if the event has listeners, use it for arguments that are expensive to compute.
+	template <typename ... Producers>
+	void BroadcastLazy(Producers&& ... producers)
+	{
+		typedef TGameEventSignature<typename TDecay<decltype(producers())>::Type...> Signature;
+
+		if (!IsEnabled())
+			return;
+
+		if (Signature::Hash != m_signatureHash)
+		{
+			ReportSignatureMismatch(TEXT("BroadcastLazy"), Signature::TypeIndices, Signature::Num);
+			return;
+		}
+
+		if (!NeedsValues())
+			return;
+
+		// Fold instead of SetValues(producers()...), so the producers run in order.
+		int32 index = 0;
+		(AssignArg(m_eventArgs[index++].m_type.Get<typename TDecay<decltype(producers())>::Type>(), producers()), ...);
+		BroadcastDelegate();
+	}
+
+	/// True if a broadcast of this event would reach anyone.
+	FORCEINLINE bool HasListeners() const
+	{
+		return m_listeners.Num() > 0 || m_numSpatialListeners > 0 || m_waiters != nullptr || m_delegate.IsBound() || (m_dynamicDelegatePtr != nullptr && m_dynamicDelegatePtr->IsBound());
+	}
+
+	/// True if a broadcast has to write its arguments, because somebody listens or because the event keeps them.
+	FORCEINLINE bool NeedsValues() const
+	{
+		return m_keepsValues || HasListeners();
+	}
+
+	/// Writes the params sent to Broadcast() into the arguments, in order. The signature must have been validated already.
+	template <typename ... Args>
+	FORCEINLINE void SetValues(Args&& ... args)
+	{
+		int32 index = 0;
+		(AssignArg(m_eventArgs[index++].m_type.Get<typename TDecay<Args>::Type>(), Forward<Args>(args)), ...);
+	}
+
+	template <typename T>
+	T GetValue(const FName& id)
+	{
+		const int32 index = m_argHash.Find(id);
+
+		if (index == INDEX_NONE)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Variable '%s' could not be found in event '%s'"), *id.ToString(), *m_name.ToString());
+			return T();
+		}
+
+		CEventArg* found = &m_eventArgs[index];
+
+		if (found->m_type.GetIndex() == EventArgType::IndexOfType<T>())
+		{
+			return found->m_type.Get<T>();
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("Requested variable '%s' in event '%s' with the wrong type!"), *id.ToString(), *m_name.ToString());
+			return T();
+		}
+		
+	}
+
+	UFUNCTION(BlueprintCallable)
+	int GetInt(FName id)
+	{
+		return GetValue<int>(id);
+	}
+
+	UFUNCTION(BlueprintCallable)
+	float GetFloat(FName id)
+	{
+		return GetValue<float>(id);
+	}
+
+
+	UFUNCTION(BlueprintCallable)
+	bool GetBool(FName id)
+	{
+		return GetValue<bool>(id);
+	}
+
+	UFUNCTION(BlueprintCallable)
+	FVector GetFVector(FName id)
+	{
+		return GetValue<FVector>(id);
+	}
+
+	UFUNCTION(BlueprintCallable)
+	FVector2D GetFVector2D(FName id)
+	{
+		return GetValue<FVector2D>(id);
+	}
+
+	UFUNCTION(BlueprintCallable)
+	FRotator GetFRotator(FName id)
+	{
+		return GetValue<FRotator>(id);
+	}
+
+	UFUNCTION(BlueprintCallable)
+	UObject* GetUObject(FName id)
+	{
+		return GetValue<UObject*>(id);
+	}
+
+	UFUNCTION(BlueprintCallable)
+	AActor* GetActor(FName id)
+	{
+		return GetValue<AActor*>(id);
+	}
+
+	FEventArgStruct* GetStruct(FName id)
+	{
+		return GetValue<FEventArgStruct*>(id);
+	}
+
+	UFUNCTION(BlueprintCallable)
+	uint8 GetUEnum(FName id)
+	{
+		return GetValue<uint8>(id);
+	}
+
+	/// Returns every argument at once, e.g. auto [item, amount] = ev.Unpack<FName, int>();
+	/// The whole signature is checked in a single pass. If it doesn't match, an error is logged and default values are returned.
+	template <typename ... Ts>
+	TTuple<Ts...> Unpack() const
+	{
+		if (!MatchesSignature<Ts...>())
+		{
+			ReportSignatureMismatch(TEXT("Unpack"), TGameEventSignature<Ts...>::TypeIndices, TGameEventSignature<Ts...>::Num);
+			return TTuple<Ts...>();
+		}
+
+		return UnpackUnchecked<Ts...>(TMakeIntegerSequence<uint32, sizeof...(Ts)>());
+	}
+
+	/// Target of the "Break Game Event" blueprint node, not meant to be called directly.
+	/// The node calls it once per output pin with the argument's index in the table, so reading an argument skips the name lookup and allocates nothing.
+	/// The value is written straight into the typed output pin, id only catches a table edited after the blueprint was compiled.
+	UFUNCTION(BlueprintPure, CustomThunk, meta = (BlueprintInternalUseOnly = "true", CustomStructureParam = "value"))
+	void GetValueAt(int32 index, FName id, int32& value) const;
+	DECLARE_FUNCTION(execGetValueAt);
+
+	/// Index of an argument in the order of the table, or INDEX_NONE.
+	FORCEINLINE int32 FindArgIndex(const FName& id) const { return m_argHash.Find(id); }
+
+	/// Parses text into a value of the argument's type. Object arguments can't be parsed.
+	bool ParseArgValue(int32 index, const FString& text, EventArgType& value) const;
+
+	/// Compares the current value of an argument with the given one. Floats and vectors are compared with a tolerance.
+	bool ArgEquals(int32 index, const EventArgType& value) const;
+
+protected:
+	/// Set by UGameEventDynamic, so dispatching doesn't need a virtual call.
+	FGameEventDelegateDynamic* m_dynamicDelegatePtr = nullptr;
+
+private:
+	/// Calls every listener, native and Blueprint. Blueprint listeners bound with the same function are kept next to each other, otherwise it's the order they were bound in.
+	void BroadcastDelegate();
+	void CompactListeners();
+	void MarkListenerRemoved(FGameEventListener& listener);
+
+	/// Stores the packed arguments for latched, published and recorded events. Out of line, the broadcast only carries the branch.
+	FORCENOINLINE void KeepValues();
+
+	/// Adds a listener entry, Blueprint listeners are kept next to the ones with the same function. Replays the latched value if asked to.
+	void InsertListener(FGameEventListener&& listener, bool replayLatched);
+
+	/// Resolves the function of a Blueprint listener once. Fails if the object doesn't have it, target is only used for the error message.
+	static bool MakeBlueprintListener(const FGameEventListenerDynamic& listener, const FString& target, FGameEventListener& outListener);
+
+	FORCEINLINE bool HasListener(FDelegateHandle handle) const
+	{
+		return m_listeners.ContainsByPredicate([&handle](const FGameEventListener& listener) { return listener.m_handle == handle; });
+	}
+
+	/// Calls a single, just bound listener with the latched arguments.
+	void ReplayLatched(int32 listenerIndex);
+
+	/// Resumes every coroutine awaiting this event. With cancel, they are resumed with a null event instead.
+	void ResumeWaiters(bool cancel);
+	void RemoveWaiter(FGameEventAwaiter* waiter);
+
+	/// Resumes every waiting coroutine with a null event. Runs gameplay code, so never from within garbage collection.
+	FORCEINLINE void CancelWaiters()
+	{
+		if (m_waiters != nullptr)
+			ResumeWaiters(true);
+	}
+
+	/// Moves the waiting coroutines of an event replaced during a reload over to this one.
+	void TakeWaiters(UGameEvent& from);
+
+	/// Detaches the waiting coroutines without running them, they are resumed with a null event on the next core tick.
+	/// Used from BeginDestroy(), where running gameplay code isn't safe.
+	void OrphanWaiters();
+	static bool ResumeOrphanedWaiters(float deltaTime);
+	static void RemoveOrphanedWaiter(FGameEventAwaiter* waiter);
+
+	virtual void BeginDestroy() override;
+
+	/// Reports the arguments of latched events, they are replayed long after the broadcast. Destroyed actors are nulled by the collector.
+	static void AddReferencedObjects(UObject* inThis, FReferenceCollector& collector);
+
+	/// Rebuilds the argument name hash and the signature hash, whenever the argument list changes.
+	void BuildArgLookups();
+
+	/// Writes a value coming from the blueprint VM into an argument. Fails if the property doesn't match the argument's type.
+	bool SetValueFromProperty(int32 index, const FProperty* property, const void* address);
+
+	/// True if SetValueFromProperty() would accept the property, without writing anything.
+	bool AcceptsProperty(int32 index, const FProperty* property) const;
+
+	/// Writes an argument into a value of the blueprint VM, the counterpart of SetValueFromProperty(). Fails if the property doesn't match the argument's type.
+	bool GetValueToProperty(int32 index, const FProperty* property, void* address) const;
+
+	/// Logs why a signature didn't match. Kept out of line and shared by every signature, so none of the templates carry their own logging code.
+	FORCENOINLINE void ReportSignatureMismatch(const TCHAR* context, const SIZE_T* typeIndices, int32 num) const;
+
+	template <typename ... Ts, uint32 ... Indices>
+	FORCEINLINE TTuple<Ts...> UnpackUnchecked(TIntegerSequence<uint32, Indices...>) const
+	{
+		return TTuple<Ts...>(m_eventArgs[Indices].m_type.Get<Ts>()...);
+	}
+
+	/// The argument already holds a value of this type, so assign into it instead of re-constructing the variant.
+	/// Moves just steal the buffer, and string copies reuse the capacity of the previous value.
+	template <typename T, typename V>
+	static FORCEINLINE void AssignArg(T& target, V&& value)
+	{
+		target = Forward<V>(value);
+	}
+
+	static FORCEINLINE void AssignArg(FString& target, const FString& value)
+	{
+		target.Reset(value.Len());
+		target.Append(value);
+	}
+
+	static FORCEINLINE void AssignArg(FString& target, FString& value)
+	{
+		AssignArg(target, static_cast<const FString&>(value));
+	}
+
+	/// Calls the listener with every argument, the caller validated the signature.
+	template <typename ... Ts, typename F, uint32 ... Indices>
+	FORCEINLINE void InvokeUnpacked(F& listener, TIntegerSequence<uint32, Indices...>)
+	{
+		listener(m_eventArgs[Indices].m_type.Get<Ts>()...);
+	}
+
+private:
+	friend class UGameEventManager;
+	TArray<CEventArg> m_eventArgs;
+	FGameEventNameHash m_argHash;
+	uint64 m_signatureHash = GameEventSignatureHashBasis;
+	TArray<FGameEventListener> m_listeners;
+	FGameEventDelegate m_delegate;
+	int32 m_dispatchDepth = 0;
+	bool m_hasRemovedListeners = false;
+	FName m_name = "";
+	bool m_isDynamic = false;
+	bool m_isLatched = false;
+	bool m_storesLatest = false;
+	EGameEventPriority m_priority = EGameEventPriority::Normal;
+	int32 m_historySize = 0;
+
+	/// Index of the FVector argument spatial listeners are matched against, INDEX_NONE if the event has no location.
+	FName m_locationArgName = "";
+	int32 m_locationArgIndex = INDEX_NONE;
+	int32 m_numSpatialListeners = 0;
+	int32 m_coalescedCount = 1;
+
+	/// Owns the spatial grid of this event.
+	UGameEventManager* m_manager = nullptr;
+
+	/// True if the event stores its latest value or records a history, both need the packed arguments of every broadcast.
+	bool m_keepsValues = false;
+
+	/// Packed layout, and copy of the last broadcast, only written for latched and published events.
+	/// Built when the event is instantiated, if it stores its latest value or records a history. Null otherwise.
+	/// Replaced snapshots are kept until the event is destroyed, readers on other threads might still be using them. Reloads are rare enough.
+	std::atomic<FGameEventLatestSnapshot*> m_snapshot { nullptr };
+	TArray<TUniquePtr<FGameEventLatestSnapshot>> m_snapshots;
+	TUniquePtr<FGameEventHistory> m_history;
+
+	/// Intrusive lists of suspended coroutines, the nodes live in the coroutine frames.
+	friend struct FGameEventAwaiter;
+	FGameEventAwaiter* m_waiters = nullptr;
+	FGameEventAwaiter* m_resumingWaiters = nullptr;
+
+	/// Waiters of events destroyed by garbage collection, waiting for ResumeOrphanedWaiters().
+	static FGameEventAwaiter* s_orphanedWaiters;
+
+	/// Word of the manager's enable mask holding this event's bit. Checking it is one load and a branch.
+	const uint32* m_enabledWord = &s_alwaysEnabled;
+	uint32 m_enabledBit = 1;
+	static const uint32 s_alwaysEnabled;
+	static const FGameEventPackedLayout s_emptyLayout;
+};
+
+/**
+* Same as UGameEvent, however this sub-class also exposes an assignable dynamic delegate.
+* Use only for the events that you want to listen through blueprints by binding m_dynamicDelegate, UGameEvent::Listen() works for any event.
+*/
+UCLASS(BlueprintType, Blueprintable)
+class UGameEventDynamic : public UGameEvent
+{
+	GENERATED_BODY()
+
+public:
+	UGameEventDynamic()
+	{
+		m_dynamicDelegatePtr = &m_dynamicDelegate;
+	};
+
+	virtual ~UGameEventDynamic() override
+	{
+	};
+
+	FORCEINLINE FGameEventDelegateDynamic& GetDynDelegate() { return m_dynamicDelegate; }
+
+	UPROPERTY(BlueprintAssignable)
+	FGameEventDelegateDynamic m_dynamicDelegate;
+};
+
+/**
+* Refers to a broadcast scheduled with UGameEventManager::BroadcastAfter() or BroadcastEvery(), used to cancel it.
+* Stays safe to use after the broadcast fired or got cancelled, timer slots are reused with a new serial.
+*/
+struct FGameEventTimerHandle
+{
+public:
+	FORCEINLINE bool IsValid() const { return m_index != INDEX_NONE; }
+	FORCEINLINE void Invalidate() { m_index = INDEX_NONE; }
+
+	int32 m_index = INDEX_NONE;
+	uint32 m_serial = 0;
+};
+
+/**
+* A scheduled broadcast, living in the manager's timer pool.
+* The arguments are captured when it's scheduled. Up to four of them are stored inline, and pooled timers keep their capacity,
+* so scheduling doesn't allocate once the pool is warm.
+*/
+struct FGameEventTimer
+{
+	FGameEventHandle m_event;
+	uint64 m_signatureHash = 0;
+	TArray<EventArgType, TInlineAllocator<4>> m_args;
+
+	/// Absolute deadline in seconds of manager time. Periodic timers add the period to it, so rounding never accumulates.
+	double m_deadline = 0.0;
+	double m_period = 0.0;
+
+	/// Wheel slot the timer is linked into, INDEX_NONE while it's free. m_next doubles as the free list link.
+	int32 m_slot = INDEX_NONE;
+	int32 m_prev = INDEX_NONE;
+	int32 m_next = INDEX_NONE;
+	uint32 m_serial = 0;
+};
+
+/**
+* A call to UGameEventManager::SetEventEnabled() or SetCategoryEnabled(), kept so it survives reloads and console variable changes.
+*/
+struct FGameEventEnableOverride
+{
+	FName m_name;
+	bool m_isCategory = false;
+	bool m_enabled = true;
+};
+
+/**
+* A broadcast queued for the deferred dispatcher, living in the manager's pool like the timers.
+*/
+struct FGameEventDeferredBroadcast
+{
+	FGameEventHandle m_event;
+	uint64 m_signatureHash = 0;
+	TArray<EventArgType, TInlineAllocator<4>> m_args;
+	int32 m_nextFree = INDEX_NONE;
+};
+
+/**
+* Counters of the deferred dispatcher, see UGameEventManager::GetDeferredStats().
+*/
+USTRUCT(BlueprintType)
+struct FGameEventDeferredStats
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadOnly, meta = (DisplayName = "Queued"))
+	int64 m_queued = 0;
+
+	UPROPERTY(BlueprintReadOnly, meta = (DisplayName = "Dispatched"))
+	int64 m_dispatched = 0;
+
+	/// Frames that ran out of budget and carried broadcasts over to the next frame.
+	UPROPERTY(BlueprintReadOnly, meta = (DisplayName = "Frames Over Budget"))
+	int64 m_framesOverBudget = 0;
+
+	/// Sum of the broadcasts left in the queue at the end of each frame over budget.
+	UPROPERTY(BlueprintReadOnly, meta = (DisplayName = "Carried Over"))
+	int64 m_carriedOver = 0;
+
+	/// Frames where dispatching took longer than the budget, because a single broadcast exceeded what was left of it.
+	UPROPERTY(BlueprintReadOnly, meta = (DisplayName = "Overruns"))
+	int64 m_overruns = 0;
+
+	UPROPERTY(BlueprintReadOnly, meta = (DisplayName = "Max Overrun Ms"))
+	float m_maxOverrunMs = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, meta = (DisplayName = "Max Queue Length"))
+	int32 m_maxQueueLength = 0;
+};
+
+/**
+ * Handles the initialization & management of events.
+ */
+UCLASS(BlueprintType, Blueprintable, Config = Game)
+class PROJECTSNIPER_API UGameEventManager : public UObject, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	UGameEventManager();
+
+	void Setup();
+	void Clear();
+
+	/// Picks up DataTable edits without touching listeners. New rows become events, removed rows are dropped,
+	/// and argument layouts of the existing events are migrated in place. In editor builds this runs automatically whenever the table changes.
+	UFUNCTION(BlueprintCallable)
+	void Reload();
+
+	/// Returns null and fails if the event doesn't exist, or if it isn't marked as dynamic in the table.
+	UFUNCTION(BlueprintCallable)
 	UGameEventDynamic* GetDynamic(FName id, bool& success);
 
 	UGameEvent& Get(const FName& id);
 
+	/// Resolves an event name once, store the handle and use it with the handle overloads afterwards.
+	UFUNCTION(BlueprintCallable)
+	FGameEventHandle ResolveEvent(FName id, bool& success);
+
+	/// Same as GetDynamic(), through a handle. The handle is updated in case a reload moved the event.
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Get Dynamic (Handle)"))
+	UGameEventDynamic* GetDynamicByHandle(UPARAM(ref) FGameEventHandle& handle, bool& success);
+
+	UGameEvent& Get(FGameEventHandle& handle);
+
+	/// Shorthand for Get(id).Subscribe<Ts...>(listener).
+	template <typename ... Ts, typename F>
+	FDelegateHandle Subscribe(const FName& id, F&& listener)
+	{
+		return Get(id).Subscribe<Ts...>(Forward<F>(listener));
+	}
+
+	template <typename ... Ts, typename F>
+	FDelegateHandle Subscribe(FGameEventHandle& handle, F&& listener)
+	{
+		return Get(handle).Subscribe<Ts...>(Forward<F>(listener));
+	}
+
+	/// Binds a listener to every event matching the pattern, e.g. "Combat.Damage.*" for Combat.Damage.Headshot, Combat.Damage.Fall and so on.
+	/// The pattern is resolved here, through a prefix tree over the registry, and the listener lands in the listener list of each matching event.
+	/// Broadcasts don't do any matching. Events added by a reload are bound as well. Returns an invalid handle if the pattern is malformed.
+	FDelegateHandle AddWildcardListener(const FString& pattern, FGameEventDelegate::FDelegate&& listener);
+
+	void RemoveWildcardListener(FDelegateHandle handle);
+
+	/// Blueprint version of AddWildcardListener().
+	UFUNCTION(BlueprintCallable)
+	void ListenWildcard(const FString& pattern, const FGameEventListenerDynamic& listener);
+
+	UFUNCTION(BlueprintCallable)
+	void StopListeningWildcard(const FString& pattern, const FGameEventListenerDynamic& listener);
+
+	/// Binds a listener that is only called for broadcasts within radius of position, measured to the event's "Location Argument".
+	/// Listeners are kept in a uniform grid per event, a broadcast only visits the listeners of the cell it happens in.
+	/// With useLod, listeners far from the broadcast are called at the reduced rate of their LOD tier, see m_lodTiers.
+	/// Returns an invalid handle if the event doesn't exist or has no location argument.
+	FGameEventSpatialHandle AddSpatialListener(FGameEventHandle& handle, const FVector& position, float radius, FGameEventDelegate::FDelegate&& listener, bool useLod = true);
+
+	/// Blueprint version of AddSpatialListener().
+	UFUNCTION(BlueprintCallable)
+	FGameEventSpatialHandle ListenNearby(UPARAM(ref) FGameEventHandle& handle, FVector position, float radius, const FGameEventListenerDynamic& listener, bool useLod = true);
+
+	/// Scales the distance used to pick the LOD tier of a spatial listener, e.g. from the significance manager. Below one moves it to lower rate tiers.
+	UFUNCTION(BlueprintCallable)
+	void SetSpatialListenerSignificance(const FGameEventSpatialHandle& spatialHandle, float significance);
+
+	UFUNCTION(BlueprintPure)
+	FGameEventLodStats GetLodStats() const { return m_lodStats; }
+
+	UFUNCTION(BlueprintCallable)
+	void ResetLodStats() { m_lodStats = FGameEventLodStats(); }
+
+	/// Moves a spatial listener, e.g. every time its actor moved. Only touches the grid when the listener crosses a cell boundary.
+	UFUNCTION(BlueprintCallable)
+	void MoveSpatialListener(const FGameEventSpatialHandle& spatialHandle, FVector position);
+
+	UFUNCTION(BlueprintCallable)
+	void RemoveSpatialListener(UPARAM(ref) FGameEventSpatialHandle& spatialHandle);
+
+	/// Awaitable for the next broadcast of an event, e.g. UGameEvent* ev = co_await Manager->Next(Handle);
+	/// Only available with C++20 coroutines, see WITH_GAME_EVENT_COROUTINES.
+	FGameEventAwaiter Next(FGameEventHandle& handle);
+	FGameEventAwaiter Next(const FName& id);
+
+	/// Broadcasts the event with the given arguments once, after delay seconds. The signature is checked now, the arguments are captured by value.
+	/// Returns an invalid handle if the event doesn't exist or the signature doesn't match.
+	template <typename ... Args>
+	FGameEventTimerHandle BroadcastAfter(FGameEventHandle& handle, float delay, Args&& ... args)
+	{
+		return ScheduleBroadcast(TEXT("BroadcastAfter"), handle, delay, 0.0, Forward<Args>(args)...);
+	}
+
+	template <typename ... Args>
+	FGameEventTimerHandle BroadcastAfter(const FName& id, float delay, Args&& ... args)
+	{
+		FGameEventHandle handle = MakeHandle(id);
+		return BroadcastAfter(handle, delay, Forward<Args>(args)...);
+	}
+
+	/// Broadcasts the event every period seconds, the first time one period from now, until it's cancelled.
+	/// Deadlines are absolute, the n-th broadcast is due at n * period no matter how long the frames were. Missed periods are caught up within the same frame.
+	template <typename ... Args>
+	FGameEventTimerHandle BroadcastEvery(FGameEventHandle& handle, float period, Args&& ... args)
+	{
+		if (period <= 0.0f)
+		{
+			UE_LOG(LogTemp, Error, TEXT("BroadcastEvery: event '%s' needs a period greater than zero."), *handle.m_name.ToString());
+			return FGameEventTimerHandle();
+		}
+
+		return ScheduleBroadcast(TEXT("BroadcastEvery"), handle, period, period, Forward<Args>(args)...);
+	}
+
+	template <typename ... Args>
+	FGameEventTimerHandle BroadcastEvery(const FName& id, float period, Args&& ... args)
+	{
+		FGameEventHandle handle = MakeHandle(id);
+		return BroadcastEvery(handle, period, Forward<Args>(args)...);
+	}
+
+	/// Queues a broadcast, dispatched from the manager's tick within m_deferredBudgetMs per frame. What doesn't fit carries over to the next frame.
+	/// Use it for broadcasts that come in storms, e.g. mass ragdoll deaths. Events with the Critical priority are broadcast right away instead.
+	/// The signature is checked now, the arguments are captured by value.
+	template <typename ... Args>
+	void BroadcastDeferred(FGameEventHandle& handle, Args&& ... args)
+	{
+		typedef TGameEventSignature<typename TDecay<Args>::Type...> Signature;
+
+		UGameEvent* ev = FindOrInstantiate(handle);
+		if (ev == nullptr)
+		{
+			UE_LOG(LogTemp, Error, TEXT("BroadcastDeferred: event '%s' could not be found."), *handle.m_name.ToString());
+			return;
+		}
+
+		if (ev->m_priority == EGameEventPriority::Critical)
+		{
+			ev->Broadcast(Forward<Args>(args)...);
+			return;
+		}
+
+		if (Signature::Hash != ev->m_signatureHash)
+		{
+			ev->ReportSignatureMismatch(TEXT("BroadcastDeferred"), Signature::TypeIndices, Signature::Num);
+			return;
+		}
+
+		const int32 index = AllocateDeferred(handle, Signature::Hash, ev->m_priority);
+		TArray<EventArgType, TInlineAllocator<4>>& payload = m_deferred[index].m_args;
+		(payload.Emplace(TInPlaceType<typename TDecay<Args>::Type>(), Forward<Args>(args)), ...);
+	}
+
+	template <typename ... Args>
+	void BroadcastDeferred(const FName& id, Args&& ... args)
+	{
+		FGameEventHandle handle = MakeHandle(id);
+		BroadcastDeferred(handle, Forward<Args>(args)...);
+	}
+
+	/// Number of deferred broadcasts waiting to be dispatched.
+	UFUNCTION(BlueprintPure)
+	int32 GetNumDeferred() const;
+
+	UFUNCTION(BlueprintPure)
+	FGameEventDeferredStats GetDeferredStats() const { return m_deferredStats; }
+
+	UFUNCTION(BlueprintCallable)
+	void ResetDeferredStats() { m_deferredStats = FGameEventDeferredStats(); }
+
+	/// Cancels a scheduled broadcast and invalidates the handle. Returns false if it already fired or was cancelled.
+	bool CancelBroadcast(FGameEventTimerHandle& timer);
+
+	bool IsBroadcastScheduled(const FGameEventTimerHandle& timer) const;
+
+	/// Advances manager time and fires every scheduled broadcast that became due, in deadline order. Called from Tick().
+	void AdvanceTimers(float deltaTime);
+
+	// FTickableGameObject, the manager only ticks while broadcasts are scheduled.
+	virtual void Tick(float deltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual TStatId GetStatId() const override;
+
+	/// Reports the objects captured in pending payloads, they aren't UPROPERTYs. Destroyed actors are nulled by the collector instead of left dangling.
+	static void AddReferencedObjects(UObject* inThis, FReferenceCollector& collector);
+
+	/// Target of the "Broadcast Game Event" blueprint node, not meant to be called directly.
+	/// The node checks its typed input pins against the table when the blueprint compiles, and passes them as numArgs extra parameters.
+	/// They are written straight into the event's arguments, so a blueprint broadcast is a single native call.
+	UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true", Variadic))
+	void BroadcastVariadic(FName id, int32 numArgs);
+	DECLARE_FUNCTION(execBroadcastVariadic);
+
+	/// Enables or disables a single event. Broadcasts of disabled events return right away, before any argument is touched.
+	/// Overrides the config and the console variable, and stays in effect across reloads until ResetEnableOverrides().
+	UFUNCTION(BlueprintCallable)
+	void SetEventEnabled(FName id, bool enabled);
+
+	/// Enables or disables every event of the given category. Kept across reloads like SetEventEnabled().
+	UFUNCTION(BlueprintCallable)
+	void SetCategoryEnabled(FName category, bool enabled);
+
+	/// Drops every SetEventEnabled() and SetCategoryEnabled() call, only the config and the console variable apply again.
+	UFUNCTION(BlueprintCallable)
+	void ResetEnableOverrides();
+
+	UFUNCTION(BlueprintPure)
+	bool IsEventEnabled(FName id) const;
+
+	/// Resets the enable mask: everything is enabled, except the events and categories listed in the config and in the GameEvents.Disabled console variable.
+	/// Runtime SetEventEnabled() and SetCategoryEnabled() calls are applied on top.
+	/// Called by Setup() and Reload(), and whenever the console variable changes.
+	void ApplyDisabledEvents();
+
+	/// Reads the packed arguments of the last broadcast of an event published with "Publish Latest Value?", or of a latched event.
+	/// Safe to call from any thread, resolve the handle on the game thread first. Returns false for any other event, or before its first broadcast.
+	/// Goes through the manager's event array, which Reload() rebuilds. Threads that might run during a reload hold on to the event and use UGameEvent::ReadLatest().
+	bool ReadLatest(const FGameEventHandle& handle, TArray<uint8>& outPacked, const FGameEventPackedLayout** outLayout = nullptr) const;
+
+	/// Bakes the DataTable into the registry arrays. Called automatically on save/cook, and by Setup() if the registry is missing.
+	void BuildRegistry();
+
+#if WITH_EDITOR
+	virtual void PreSave(const class ITargetPlatform* targetPlatform) override;
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& propertyChangedEvent) override;
+
+	/// True if the table might have changed since the registry was baked. Nothing is known before the first bake of an editor session.
+	bool IsRegistryStale() const;
+#endif
+
+private:
+	UGameEvent* FindOrInstantiate(const FName& id);
+	UGameEvent* FindOrInstantiate(FGameEventHandle& handle);
+	UGameEvent* FindOrInstantiate(int32 index);
+	UGameEventDynamic* CastDynamic(UGameEvent* ev, bool& success) const;
+	UGameEvent* InstantiateEvent(int32 index);
+	void MigrateEvent(UGameEvent& ev, const FGameEventRegistryEntry& entry);
+	void BuildEventHash();
+	void LinkEnableBit(UGameEvent& ev, int32 index);
+	void UnlinkEnableBit(UGameEvent& ev);
+	void SetEnabledBit(int32 index, bool enabled);
+	void SetEnabledByName(const FName& nameOrCategory, bool enabled);
+	void SetCategoryBits(const FName& category, bool enabled);
+	void AddEnableOverride(const FName& name, bool isCategory, bool enabled);
+	static EventArgType MakeDefaultArg(EEventArgTypes type);
+	FGameEventHandle MakeHandle(const FName& id) const;
+
+	template <typename ... Args>
+	FGameEventTimerHandle ScheduleBroadcast(const TCHAR* context, FGameEventHandle& handle, double delay, double period, Args&& ... args)
+	{
+		typedef TGameEventSignature<typename TDecay<Args>::Type...> Signature;
+
+		UGameEvent* ev = FindOrInstantiate(handle);
+		if (ev == nullptr)
+		{
+			UE_LOG(LogTemp, Error, TEXT("%s: event '%s' could not be found."), context, *handle.m_name.ToString());
+			return FGameEventTimerHandle();
+		}
+
+		if (Signature::Hash != ev->m_signatureHash)
+		{
+			ev->ReportSignatureMismatch(context, Signature::TypeIndices, Signature::Num);
+			return FGameEventTimerHandle();
+		}
+
+		const int32 index = AllocateTimer(handle, Signature::Hash, delay, period);
+		TArray<EventArgType, TInlineAllocator<4>>& payload = m_timers[index].m_args;
+		(payload.Emplace(TInPlaceType<typename TDecay<Args>::Type>(), Forward<Args>(args)), ...);
+
+		FGameEventTimerHandle timer;
+		timer.m_index = index;
+		timer.m_serial = m_timers[index].m_serial;
+		return timer;
+	}
+
+	FDelegateHandle AddWildcard(const FString& pattern, FGameEventListener&& listener);
+
+	/// Binds the wildcard listeners to every matching event that doesn't have them yet, after a reload.
+	void ApplyWildcardListeners();
+
+	FGameEventSpatialHandle AddSpatial(FGameEventHandle& handle, const FVector& position, float radius, FGameEventListener&& listener, bool useLod);
+	bool IsSpatialHandleValid(const FGameEventSpatialHandle& spatialHandle) const;
+	FIntVector GetSpatialCell(const FVector& position) const;
+	static bool IsSpatialRangeOversized(const FIntVector& minCell, const FIntVector& maxCell);
+	void LinkSpatialListener(int32 index);
+	void UnlinkSpatialListener(int32 index);
+	void RemoveFromSpatialCell(const FGameEventSpatialCell& key, int32 index);
+	void FreeSpatialListener(int32 index);
+
+	/// Calls the spatial listeners of the event near the location, from UGameEvent::BroadcastDelegate().
+	void DispatchSpatial(UGameEvent& ev, const FVector& location);
+
+	/// Frame interval of the LOD tier for the given distance, one for full rate.
+	int32 GetLodFrameInterval(float distance) const;
+
+	/// Calls a spatial listener, false if its Blueprint object is gone.
+	static bool InvokeSpatialListener(FGameEventSpatialListener& spatial, UGameEvent& ev);
+
+	/// Delivers the coalesced broadcasts that became due, from Tick().
+	void FlushLodDeliveries();
+
+	/// Returns the slots of listeners removed during a dispatch to the pool.
+	void ReleasePendingSpatialListeners();
+
+	/// Reload support, spatial listeners follow their event to a new object or are dropped with it.
+	void RebindSpatialListeners(UGameEvent* from, UGameEvent* to);
+
+	/// Checks that a captured payload still fits its event, a reload might have removed the event or changed its arguments.
+	UGameEvent* ResolvePayloadEvent(FGameEventHandle& handle, uint64 signatureHash, const TCHAR* context);
+
+	int32 AllocateDeferred(const FGameEventHandle& handle, uint64 signatureHash, EGameEventPriority priority);
+	void DispatchDeferred(int32 index);
+
+	/// Dispatches queued broadcasts until the frame budget runs out, from Tick().
+	void ProcessDeferred();
+
+	int32 AllocateTimer(const FGameEventHandle& handle, uint64 signatureHash, double delay, double period);
+	void FreeTimer(int32 index);
+	void LinkTimer(int32 index, bool allowCurrentTick);
+	void UnlinkTimer(int32 index);
+	void CascadeTimers(int32 level);
+	void FireTimer(int32 index);
+	void ClearTimers();
+
 private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = true))
 	UDataTable* m_eventDefinitions = nullptr;
 
+	/// If true, Setup() doesn't create any events. Each event is created the first time it's requested through Get() or GetDynamic().
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = true, DisplayName = "Lazy Instantiation"))
+	bool m_lazyInstantiation = false;
+
+	/// Events by registry index. Lazy events stay null until they are requested.
+	UPROPERTY()
+	TArray<UGameEvent*> m_events;
+
+	UPROPERTY()
+	TArray<FGameEventRegistryEntry> m_registry;
+
+	UPROPERTY()
+	TArray<FName> m_registryArgNames;
+
+	UPROPERTY()
+	TArray<EEventArgTypes> m_registryArgTypes;
+
+	/// Event names or categories disabled at startup, set in the [/Script/YourModule.GameEventManager] section of DefaultGame.ini.
+	UPROPERTY(Config)
+	TArray<FName> m_disabledEvents;
+
+	/// Runtime enable/disable calls in the order they were made, applied on top of the config and the console variable.
+	TArray<FGameEventEnableOverride> m_enableOverrides;
+
+	/// Event name to registry index.
+	FGameEventNameHash m_eventHash;
+
+	/// Dot separated event names to registry indices, for wildcard subscriptions.
+	FGameEventNameTrie m_eventTrie;
+
+	TArray<FGameEventWildcardListener> m_wildcardListeners;
+
+	/// Edge length of the cells of the spatial grid. Pick it around the typical listener radius.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = true, DisplayName = "Spatial Cell Size", ClampMin = "1"))
+	float m_spatialCellSize = 2000.0f;
+
+	/// Listeners spanning more cells than this go to a single list per event, visited by every broadcast.
+	static constexpr int32 MaxSpatialCellsPerListener = 64;
+	static const FIntVector OversizedSpatialCell;
+
+	/// Pooled spatial listeners, and the grid of all events mapping cells to the listeners overlapping them.
+	TArray<FGameEventSpatialListener> m_spatialListeners;
+	TMap<FGameEventSpatialCell, TArray<int32>> m_spatialGrid;
+	int32 m_freeSpatialListener = INDEX_NONE;
+	int32 m_spatialDispatchDepth = 0;
+
+	/// Listeners removed during a spatial dispatch. Their slots are only reused afterwards, and their delegates only destroyed then,
+	/// as one of them might be the delegate that's running.
+	TArray<int32> m_pendingFreeSpatialListeners;
+
+	/// Reduced delivery rates for spatial listeners far away from the broadcast, like LODs of animation and ticking.
+	/// Within the closest tier's distance, or without any tiers, listeners are called for every broadcast.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Config, meta = (AllowPrivateAccess = true, DisplayName = "LOD Tiers"))
+	TArray<FGameEventLodTier> m_lodTiers;
+
+	/// Spatial listeners holding a coalesced broadcast, with the serial they had when it was coalesced.
+	TArray<TPair<int32, int32>> m_pendingLodDeliveries;
+
+	FGameEventLodStats m_lodStats;
+
+	/// One bit per registry index, events point directly into it.
+	TArray<uint32> m_enabledMask;
+
+	/// Hierarchical timer wheel of scheduled broadcasts, with one millisecond ticks.
+	/// Four levels of 64 slots cover about 4.6 hours, anything further out waits in the last level and gets re-inserted on the way.
+	/// Scheduling, cancelling and firing are constant time, and timers are pooled instead of allocated one by one.
+	static constexpr double TimerTicksPerSecond = 1000.0;
+	static constexpr int32 TimerWheelBits = 6;
+	static constexpr int32 TimerWheelSlots = 1 << TimerWheelBits;
+	static constexpr int32 TimerWheelLevels = 4;
+
+	/// Extra list after the wheel slots, holding the timers that are due in the current tick.
+	static constexpr int32 TimerDueSlot = TimerWheelSlots * TimerWheelLevels;
+
+	TArray<FGameEventTimer> m_timers;
+	int32 m_timerSlots[TimerDueSlot + 1];
+	int32 m_freeTimer = INDEX_NONE;
+	int32 m_numScheduledTimers = 0;
+	double m_timerTime = 0.0;
+	uint64 m_timerTick = 0;
+	bool m_isAdvancingTimers = false;
+
+	/// Never reset, so a handle from before Clear() can't match a timer scheduled after it.
+	uint32 m_nextTimerSerial = 1;
+
+	/// Time per frame the deferred dispatcher may spend. At least one broadcast is dispatched every frame, so the queue always drains.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Config, meta = (AllowPrivateAccess = true, DisplayName = "Deferred Budget Ms", ClampMin = "0"))
+	float m_deferredBudgetMs = 1.0f;
+
+	/// Pooled deferred broadcasts, and one FIFO queue of pool indices per deferrable priority. The queues are consumed from their head index.
+	static constexpr int32 NumDeferredQueues = 2;
+	TArray<FGameEventDeferredBroadcast> m_deferred;
+	int32 m_freeDeferred = INDEX_NONE;
+	TArray<int32> m_deferredQueues[NumDeferredQueues];
+	int32 m_deferredHeads[NumDeferredQueues] = { 0, 0 };
+	FGameEventDeferredStats m_deferredStats;
+
+#if WITH_EDITOR
+	FDelegateHandle m_tableChangedHandle;
+
+	/// Starts watching m_eventDefinitions for edits if it isn't already, and clears the stale flag. Called by BuildRegistry().
+	void WatchTable();
+	void MarkRegistryStale() { m_isRegistryStale = true; }
+
+	/// Set by edits of the watched table, cleared by BuildRegistry().
+	bool m_isRegistryStale = true;
+	TWeakObjectPtr<UDataTable> m_watchedTable;
+	FDelegateHandle m_tableEditedHandle;
+#endif
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FWaitForGameEventOutput, UGameEvent*, EventData);
+
+/**
+* Latent "Wait For Game Event" blueprint node.
+* Suspends the graph until the event fires and matches every predicate, without any ticking or polling:
+* the wait is a one-shot listener on the event, removed as soon as it completes.
+* Timeouts are scheduled on the world's timer manager.
+*/
+UCLASS()
+class PROJECTSNIPER_API UWaitForGameEventAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	/// Waits until the event fires with arguments matching all the predicates. A timeout of zero or less waits forever.
+	UFUNCTION(BlueprintCallable, Category = "Game Events", meta = (BlueprintInternalUseOnly = "true", WorldContext = "worldContextObject", AutoCreateRefTerm = "predicates", DisplayName = "Wait For Game Event"))
+	static UWaitForGameEventAction* WaitForGameEvent(UObject* worldContextObject, UGameEventManager* manager, FName id, float timeout, const TArray<FGameEventArgPredicate>& predicates);
+
+	virtual void Activate() override;
+
+	UPROPERTY(BlueprintAssignable)
+	FWaitForGameEventOutput OnEvent;
+
+	UPROPERTY(BlueprintAssignable)
+	FWaitForGameEventOutput OnTimeout;
+
+private:
+	void HandleEvent(UGameEvent& ev);
+	void HandleTimeout();
+	void Finish();
+
+private:
+	UPROPERTY()
+	UGameEventManager* m_manager = nullptr;
+
 	UPROPERTY()
-	TMap<FName, UGameEvent*> m_events;
+	UGameEvent* m_event = nullptr;
+
+	TWeakObjectPtr<UWorld> m_world;
+	FName m_id = "";
+	float m_timeout = 0.0f;
+	TArray<FGameEventArgPredicate> m_predicates;
+
+	/// Predicates parsed into argument index & typed value.
+	TArray<TPair<int32, EventArgType>> m_conditions;
+
+	FDelegateHandle m_listenerHandle;
+	FTimerHandle m_timeoutHandle;
+};
+
+#if WITH_GAME_EVENT_COROUTINES
+
+/**
+* Awaiter returned by UGameEventManager::Next().
+* The awaiter itself is the node in the event's wait list. It lives in the coroutine frame, so waiting allocates nothing.
+* The coroutine is resumed from within the dispatch, while the event's arguments are set, so it can read them right away.
+* Resumes with null if the event doesn't exist or gets destroyed while waiting.
+*/
+struct FGameEventAwaiter
+{
+public:
+	explicit FGameEventAwaiter(UGameEvent* ev) : m_event(ev)
+	{
+	}
+
+	FGameEventAwaiter(const FGameEventAwaiter&) = delete;
+	FGameEventAwaiter& operator=(const FGameEventAwaiter&) = delete;
+
+	~FGameEventAwaiter()
+	{
+		// The coroutine was destroyed while waiting.
+		if (m_linked && m_event != nullptr)
+			m_event->RemoveWaiter(this);
+		else if (m_orphaned)
+			UGameEvent::RemoveOrphanedWaiter(this);
+	}
+
+	bool await_ready() const { return m_event == nullptr; }
+
+	void await_suspend(std::coroutine_handle<> handle)
+	{
+		m_handle = handle;
+		m_next = m_event->m_waiters;
+		m_event->m_waiters = this;
+		m_linked = true;
+	}
+
+	UGameEvent* await_resume() const { return m_event; }
+
+private:
+	friend class UGameEvent;
+	UGameEvent* m_event = nullptr;
+	std::coroutine_handle<> m_handle;
+	FGameEventAwaiter* m_next = nullptr;
+	bool m_linked = false;
+	bool m_orphaned = false;
+};
+
+/**
+* Recycles coroutine frames through per size class free lists, instead of going through the general allocator every time.
+* Game thread only, like the events themselves.
+*/
+class PROJECTSNIPER_API FGameEventCoroutinePool
+{
+public:
+	static void* Allocate(SIZE_T size);
+	static void Free(void* ptr, SIZE_T size);
+
+private:
+	/// Size classes are 128, 256, 512, 1024 and 2048 bytes. Bigger frames go to the general allocator.
+	static constexpr int32 NumSizeClasses = 5;
+	static int32 GetSizeClass(SIZE_T size);
+
+	struct FFreeBlock
+	{
+		FFreeBlock* m_next;
+	};
+
+	static FFreeBlock* s_freeLists[NumSizeClasses];
+};
+
+/**
+* Fire and forget coroutine type for gameplay scripts awaiting events, e.g.
+* FGameEventTask AMyActor::RunIntro() { co_await Manager->Next("OnDoorOpened"); ... }
+* Starts right away, frees its frame when it finishes. Frames come from FGameEventCoroutinePool.
+*/
+struct FGameEventTask
+{
+	struct promise_type
+	{
+		FGameEventTask get_return_object() { return FGameEventTask(); }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { check(false); }
+
+		static void* operator new(SIZE_T size) { return FGameEventCoroutinePool::Allocate(size); }
+		static void operator delete(void* ptr, SIZE_T size) { FGameEventCoroutinePool::Free(ptr, size); }
+	};
 };
+
+inline FGameEventAwaiter UGameEventManager::Next(FGameEventHandle& handle)
+{
+	return FGameEventAwaiter(FindOrInstantiate(handle));
+}
+
+inline FGameEventAwaiter UGameEventManager::Next(const FName& id)
+{
+	return FGameEventAwaiter(FindOrInstantiate(id));
+}
+
+#endif